@@ -0,0 +1,67 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+// compares a scalar integrand with a batch integrand evaluating whole blocks of coordinates at once, the batch integrand
+// receives y as a scalar so cos(y) is computed once per block, both sin + cos kernels are then bound by the calls of
+// sin while the polynomial kernel runs at the speed of the vector units, the best of several runs is reported to hide
+// the noise of the machine
+template <typename F>
+void measure(const char* name, F&& f){
+    double best = 0;
+    double result = 0;
+
+    for (int run = 0; run < 5; run++){
+        const auto start = std::chrono::steady_clock::now();
+        result = f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    std::cout << name << " result: " << result << " time: " << best << "s" << std::endl;
+}
+
+int main() {
+
+    const auto scalar = [](const double x, const double y) -> double { return sin(x)+cos(y); };
+
+    // loop over the block is left to the compiler to vectorize
+    const auto batch = [](std::span<const double> x, const double y, std::span<double> output){
+        const double cos_y = cos(y);
+        for (std::size_t i = 0; i < output.size(); i++)
+            output[i] = sin(x[i]) + cos_y;
+    };
+
+    measure("riemann scalar    ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(scalar, {{0, 10, 4000}, {0, 10, 4000}}); });
+    measure("riemann batch     ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(batch, {{0, 10, 4000}, {0, 10, 4000}}); });
+
+    measure("trapezoidal scalar", [&]{ return mz::approx::trapezoidal::approximate(scalar, {{0, 10, 4000}, {0, 10, 4000}}); });
+    measure("trapezoidal batch ", [&]{ return mz::approx::trapezoidal::approximate(batch, {{0, 10, 4000}, {0, 10, 4000}}); });
+
+    // a polynomial kernel is vectorized without any help from the math library
+    const auto polynomial_scalar = [](const double x, const double y) -> double { return x*y + x - y; };
+    const auto polynomial_batch = [](std::span<const double> x, const double y, std::span<double> output){
+        for (std::size_t i = 0; i < output.size(); i++)
+            output[i] = x[i]*y + x[i] - y;
+    };
+
+    measure("polynomial scalar ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(polynomial_scalar, {{0, 10, 4000}, {0, 10, 4000}}); });
+    measure("polynomial batch  ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(polynomial_batch, {{0, 10, 4000}, {0, 10, 4000}}); });
+
+    // the same kernel evaluated in single precision fits twice as many points in a vector register, its outputs are still
+    // summed in double by the mixed precision accumulator
+    const auto polynomial_float = [](std::span<const float> x, const float y, std::span<float> output){
+        for (std::size_t i = 0; i < output.size(); i++)
+            output[i] = x[i]*y + x[i] - y;
+    };
+
+    measure("polynomial float  ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point, mz::approx::accumulator::mixed_precision>(polynomial_float, {{0.0f, 10.0f, 4000}, {0.0f, 10.0f, 4000}}); });
+
+    return 0;
+}
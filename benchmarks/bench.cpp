@@ -0,0 +1,301 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <cmath>
+
+// benchmark harness of the grid engines, every riemann method and the trapezoidal rule are run over 1 to 6 dimensions,
+// several argument type mixes and a cheap and an expensive integrand, each case reports its throughput and its error
+// against a closed form reference, results can be written as JSON so runs of different commits can be diffed
+//
+//   approx_bench [--points N] [--min-time SECONDS] [--filter TEXT] [--json PATH]
+
+namespace {
+
+    struct options{
+        unsigned long int points = 1ul << 18;
+        double min_time = 0.05;
+        std::string filter;
+        std::string json;
+    };
+
+    struct measurement{
+        std::string method;
+        std::string types;
+        std::string integrand;
+        std::size_t dimensions = 0;
+        unsigned long int evaluations = 0;
+        unsigned long int runs = 0;
+        double seconds = 0;
+        double value = 0;
+        double reference = 0;
+    };
+
+    // argument type mixes, I is the index of the dimension
+    struct doubles{
+        static constexpr const char* name = "double";
+
+        template <std::size_t I>
+        using type = double;
+    };
+
+    struct floats{
+        static constexpr const char* name = "float";
+
+        template <std::size_t I>
+        using type = float;
+    };
+
+    struct ints{
+        static constexpr const char* name = "int";
+
+        template <std::size_t I>
+        using type = int;
+    };
+
+    struct chars{
+        static constexpr const char* name = "char";
+
+        template <std::size_t I>
+        using type = char;
+    };
+
+    struct mixed{
+        static constexpr const char* name = "mixed";
+
+        template <std::size_t I>
+        using type = std::tuple_element_t<I % 4, std::tuple<double, int, char, float>>;
+    };
+
+    // engines under test, all of them take the same kind of integration info
+    template <typename Method>
+    struct riemann_engine{
+        template <typename T>
+        using info = mz::approx::riemann::variable_integration_info<T>;
+
+        template <typename F, typename Info>
+        static double run(F& function, const Info& info){
+            return mz::approx::riemann::approximate<Method>(function, info);
+        }
+    };
+
+    struct trapezoidal_engine{
+        static constexpr const char* name = "trapezoidal";
+
+        template <typename T>
+        using info = mz::approx::trapezoidal::variable_integration_info<T>;
+
+        template <typename F, typename Info>
+        static double run(F& function, const Info& info){
+            return mz::approx::trapezoidal::approximate(function, info);
+        }
+    };
+
+    struct left_point: riemann_engine<mz::approx::riemann::method::left_point>{
+        static constexpr const char* name = "riemann::left_point";
+    };
+
+    struct mid_point: riemann_engine<mz::approx::riemann::method::mid_point>{
+        static constexpr const char* name = "riemann::mid_point";
+    };
+
+    struct right_point: riemann_engine<mz::approx::riemann::method::right_point>{
+        static constexpr const char* name = "riemann::right_point";
+    };
+
+    // floating point dimensions span [0, 1], integral ones span one unit per step so every step lands on an integer,
+    // char dimensions are limited to 100 steps to stay within its range
+    template <typename T>
+    std::tuple<double, unsigned long int> dimension_range(unsigned long int steps){
+        if constexpr (std::is_floating_point_v<T>)
+            return {1.0, steps};
+        else if constexpr (sizeof(T) == 1){
+            const auto limited = std::min(steps, 100ul);
+            return {static_cast<double>(limited), limited};
+        }
+        else
+            return {static_cast<double>(steps), steps};
+    }
+
+    // runs the integration until at least min_time has passed and returns the mean time of a single run
+    template <typename F>
+    std::tuple<double, unsigned long int> time_runs(F&& run, double min_time){
+        unsigned long int runs = 0;
+        std::chrono::duration<double> elapsed{};
+
+        const auto start = std::chrono::steady_clock::now();
+        do {
+            volatile double sink = run();
+            static_cast<void>(sink);
+            runs++;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed.count() < min_time);
+
+        return {elapsed.count() / runs, runs};
+    }
+
+    template <typename Engine, typename Mix, std::size_t ...I>
+    void run_case(const options& settings, std::vector<measurement>& results, std::index_sequence<I...>){
+
+        constexpr auto dimensions = sizeof...(I);
+
+        const auto steps = std::max(2ul, static_cast<unsigned long int>(std::llround(std::pow(settings.points, 1.0 / dimensions))));
+        const std::array<std::tuple<double, unsigned long int>, dimensions> ranges = {dimension_range<typename Mix::template type<I>>(steps)...};
+        const std::array<double, dimensions> lengths = {std::get<0>(ranges[I])...};
+
+        const typename mz::approx::internals::make_tuple_of<Engine::template info, typename Mix::template type<I>...> info =
+                {{0, static_cast<typename Mix::template type<I>>(std::get<0>(ranges[I])), std::get<1>(ranges[I])}...};
+
+        double volume = 1;
+        for (const auto length : lengths)
+            volume *= length;
+
+        // sum of the arguments, its integral is the volume times the sum of the half lengths
+        const auto cheap = [](const typename Mix::template type<I> ...x) -> double { return (0.0 + ... + x); };
+        double cheap_reference = 0;
+        for (const auto length : lengths)
+            cheap_reference += volume * length / 2;
+
+        // product of cos(u) * exp(-u) over the scaled arguments u = x / length, two transcendental calls per dimension
+        const auto expensive = [lengths](const typename Mix::template type<I> ...x) -> double {
+            return (1.0 * ... * (std::cos(x / lengths[I]) * std::exp(-x / lengths[I])));
+        };
+        const double expensive_factor = (1 + std::exp(-1.0) * (std::sin(1.0) - std::cos(1.0))) / 2;
+        const double expensive_reference = volume * std::pow(expensive_factor, dimensions);
+
+        const auto measure = [&](const auto& function, const char* integrand, double reference){
+            measurement result{Engine::name, Mix::name, integrand, dimensions};
+
+            const std::string label = result.method + "/" + result.types + "/" + std::to_string(dimensions) + "d/" + integrand;
+            if (!settings.filter.empty() && label.find(settings.filter) == std::string::npos)
+                return;
+
+            // an untimed run counts the evaluations and warms the caches up
+            unsigned long int evaluations = 0;
+            auto counted = [&](const typename Mix::template type<I> ...x) -> double { evaluations++; return function(x...); };
+            result.value = Engine::run(counted, info);
+            result.evaluations = evaluations;
+            result.reference = reference;
+
+            std::tie(result.seconds, result.runs) = time_runs([&](){ return Engine::run(function, info); }, settings.min_time);
+            results.push_back(result);
+
+            std::cout << std::left << std::setw(52) << label << std::right
+                      << std::setw(12) << result.evaluations
+                      << std::setw(14) << std::setprecision(4) << result.evaluations / result.seconds
+                      << std::setw(12) << std::setprecision(4) << result.seconds * 1e9 / result.evaluations
+                      << std::setw(14) << std::setprecision(3) << std::fabs(result.value - reference) / std::fabs(reference) << std::endl;
+        };
+
+        measure(cheap, "cheap", cheap_reference);
+        measure(expensive, "expensive", expensive_reference);
+    }
+
+    template <typename Engine, typename Mix>
+    void run_dimensions(const options& settings, std::vector<measurement>& results){
+        [&]<std::size_t ...D>(std::index_sequence<D...>){
+            (run_case<Engine, Mix>(settings, results, std::make_index_sequence<D + 1>()), ...);
+        }(std::make_index_sequence<6>());
+    }
+
+    template <typename Engine>
+    void run_engine(const options& settings, std::vector<measurement>& results){
+        run_dimensions<Engine, doubles>(settings, results);
+        run_dimensions<Engine, floats>(settings, results);
+        run_dimensions<Engine, ints>(settings, results);
+        run_dimensions<Engine, chars>(settings, results);
+        run_dimensions<Engine, mixed>(settings, results);
+    }
+
+    void write_json(const options& settings, const std::vector<measurement>& results){
+        std::ofstream stream(settings.json);
+        if (!stream)
+            throw std::runtime_error("cannot create " + settings.json);
+
+        stream << std::setprecision(17);
+        stream << "{\n  \"benchmark\": \"approx_bench\",\n"
+               << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+               << "  \"points\": " << settings.points << ",\n"
+               << "  \"min_time\": " << settings.min_time << ",\n"
+               << "  \"results\": [";
+
+        for (std::size_t i = 0; i < results.size(); i++){
+            const auto& result = results[i];
+            const double absolute_error = std::fabs(result.value - result.reference);
+
+            stream << (i ? ",\n" : "\n")
+                   << "    {\"method\": \"" << result.method << "\", \"types\": \"" << result.types
+                   << "\", \"dimensions\": " << result.dimensions << ", \"integrand\": \"" << result.integrand
+                   << "\", \"evaluations\": " << result.evaluations << ", \"runs\": " << result.runs
+                   << ", \"seconds\": " << result.seconds
+                   << ", \"points_per_second\": " << result.evaluations / result.seconds
+                   << ", \"ns_per_evaluation\": " << result.seconds * 1e9 / result.evaluations
+                   << ", \"value\": " << result.value << ", \"reference\": " << result.reference
+                   << ", \"absolute_error\": " << absolute_error
+                   << ", \"relative_error\": " << absolute_error / std::fabs(result.reference) << "}";
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+
+    options parse_options(int argc, char* argv[]){
+        options settings;
+
+        for (int i = 1; i < argc; i++){
+            const std::string argument = argv[i];
+            if (i + 1 >= argc)
+                throw std::runtime_error("missing value of " + argument);
+
+            const std::string value = argv[++i];
+            if (argument == "--points")
+                settings.points = std::stoul(value);
+            else if (argument == "--min-time")
+                settings.min_time = std::stod(value);
+            else if (argument == "--filter")
+                settings.filter = value;
+            else if (argument == "--json")
+                settings.json = value;
+            else
+                throw std::runtime_error("unknown option " + argument);
+        }
+
+        return settings;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+
+    try {
+        const auto settings = parse_options(argc, argv);
+
+        std::cout << std::left << std::setw(52) << "case" << std::right
+                  << std::setw(12) << "evaluations" << std::setw(14) << "points/s"
+                  << std::setw(12) << "ns/eval" << std::setw(14) << "rel. error" << std::endl;
+
+        std::vector<measurement> results;
+        run_engine<left_point>(settings, results);
+        run_engine<mid_point>(settings, results);
+        run_engine<right_point>(settings, results);
+        run_engine<trapezoidal_engine>(settings, results);
+
+        if (!settings.json.empty())
+            write_json(settings, results);
+
+    } catch (const std::exception& error) {
+        std::cerr << "approx_bench: " << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <chrono>
+
+// compares integrands passed as std::function with the same lambdas passed directly as callables
+template <typename F>
+void measure(const char* name, F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << " result: " << result << " time: " << elapsed.count() << "s" << std::endl;
+}
+
+int main() {
+
+    const auto lambda_2 = [](const double x) -> double { return x+1; };
+    const std::function function_2 = lambda_2;
+
+    measure("function_2 std::function", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::left_point>(function_2, {{0, 10, 10000000}}); });
+    measure("function_2 callable     ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::left_point>(lambda_2, {{0, 10, 10000000}}); });
+
+    const auto lambda_3 = [](const double x, const double y) -> double { return sin(x)+cos(y); };
+    const std::function function_3 = lambda_3;
+
+    measure("function_3 std::function", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::right_point>(function_3, {{0, 10, 3000}, {0, 10, 3000}}); });
+    measure("function_3 callable     ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::right_point>(lambda_3, {{0, 10, 3000}, {0, 10, 3000}}); });
+
+    const auto lambda_5 = [](const double x, const int y, const char z, const double v) -> double { return sin(x)+y*50+cos(z*v); };
+    const std::function function_5 = lambda_5;
+
+    measure("function_5 std::function", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(function_5, {{0, 10, 1000}, {0, 20, 10}, {0, 100, 50}, {0, 10, 10}}); });
+    measure("function_5 callable     ", [&]{ return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(lambda_5, {{0, 10, 1000}, {0, 20, 10}, {0, 100, 50}, {0, 10, 10}}); });
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <filesystem>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+// writes a sample file and integrates it through the memory mapping, both sequentially and in parallel, and compares
+// it with integrating the same samples held in memory
+template <typename F>
+void measure(const char* name, F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << " result: " << result << " time: " << elapsed.count() << "s" << std::endl;
+}
+
+int main() {
+
+    const std::size_t samples = 50'000'000;
+    const auto path = (std::filesystem::temp_directory_path() / "approx_samples.bin").string();
+
+    std::vector<double> inputs(samples);
+    std::vector<double> outputs(samples);
+    for (std::size_t index = 0; index < samples; index++){
+        inputs[index] = 10.0 * index / (samples - 1);
+        outputs[index] = std::sin(inputs[index]);
+    }
+
+    mz::approx::io::write_sample_file(path, std::make_tuple(std::span<const double>(inputs)), std::span<const double>(outputs));
+
+    using method = mz::approx::riemann::method::mid_point;
+
+    measure("in memory vectors ", [&]{ return mz::approx::riemann::approximate<method>(std::span(inputs), std::span(outputs)); });
+
+    // release the vectors so the file has to be read through the page cache
+    inputs = {};
+    outputs = {};
+
+    const mz::approx::io::sample_file file(path);
+    measure("mapped file       ", [&]{ return mz::approx::io::approximate<method>(file); });
+    measure("mapped file par   ", [&]{ return mz::approx::io::approximate<method>(mz::approx::execution::par, file); });
+
+    std::cout << "exact result: " << 1 - std::cos(10.0) << std::endl;
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,61 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <optional>
+#include <chrono>
+#include <cmath>
+
+// separates the cost of building an integration plan from the cost of executing it, a parameter sweep over
+// one integrand is integrated with a single plan and with repeated calls of approximate
+template <typename F>
+double measure(F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main() {
+
+    constexpr int sweep = 200;
+    using method = mz::approx::riemann::method::mid_point;
+
+    const auto integrand = [](double parameter){
+        return [parameter](const double x, const double y) -> double { return std::exp(-parameter * (x * x + y * y)); };
+    };
+
+    std::cout << "grid      plan build  plan execute (per integrand)  approximate (per integrand)" << std::endl;
+
+    for (const unsigned long int steps : {64ul, 256ul, 1024ul}){
+
+        std::optional<mz::approx::plan::grid_plan<double, double>> plan;
+        const double build = measure([&]{ plan.emplace(mz::approx::riemann::make_plan<method, double, double>({{0.0, 1.0, steps}, {0.0, 1.0, steps}})); });
+
+        double planned = 0;
+        const double execute = measure([&]{
+            for (int index = 0; index < sweep; index++)
+                planned += plan->execute(integrand(1.0 + index * 0.01));
+        });
+
+        double direct = 0;
+        const double approximate = measure([&]{
+            for (int index = 0; index < sweep; index++)
+                direct += mz::approx::riemann::approximate<method>(integrand(1.0 + index * 0.01), {{0.0, 1.0, steps}, {0.0, 1.0, steps}});
+        });
+
+        std::cout << steps << "x" << steps << "  " << build << "s  " << execute / sweep << "s  " << approximate / sweep << "s"
+                  << (planned == direct ? "" : "  results differ") << std::endl;
+    }
+
+    // the same plan can be shared by threads or executed in parallel
+    const auto plan = mz::approx::gauss::make_plan<8, double, double>({{0.0, 1.0, 64}, {0.0, 1.0, 64}});
+    const double sequential = plan.execute(integrand(1.0));
+    const double parallel = plan.execute(mz::approx::execution::par, integrand(1.0));
+    std::cout << "gauss plan sequential: " << sequential << " parallel: " << parallel << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <chrono>
+
+// measures speedup of the parallel execution policy over the single threaded one for a 4D mixed type integrand
+int main() {
+
+    const std::function function = [](const double x, const int y, const char z, const double v) -> double { return sin(x)+y*50+cos(z*v); };
+    const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, double, int, char, double>
+            info = {{0, 10, 1000}, {0, 20, 10}, {0, 100, 50}, {0, 10, 100}};
+
+    const auto measure = [&](unsigned int threads){
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>
+                (mz::approx::execution::parallel_policy{threads}, function, info);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::make_tuple(result, elapsed.count());
+    };
+
+    const auto hardware_threads = mz::approx::execution::number_of_threads(mz::approx::execution::par);
+    const auto [reference, reference_time] = measure(1);
+
+    std::cout << "threads: 1 result: " << reference << " time: " << reference_time << "s" << std::endl;
+    for (unsigned int threads = 2; threads <= hardware_threads; threads *= 2){
+        const auto [result, time] = measure(threads);
+        std::cout << "threads: " << threads << " result: " << result << " time: " << time << "s"
+                  << " speedup: " << reference_time / time
+                  << " reproducible: " << std::boolalpha << (result == reference) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+// compares the full grid evaluation of sin(x)+cos(y) with the same integrand declared as a separable sum, which needs
+// only the sum of the steps evaluations, then an integrand with expensive x only work evaluated on the full grid
+// and in a curried form
+template <typename F>
+void measure(const char* name, F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << " result: " << result << " time: " << elapsed.count() << "s" << std::endl;
+}
+
+int main() {
+
+    using method = mz::approx::riemann::method::right_point;
+
+    measure("full grid     ", [&]{
+        return mz::approx::riemann::approximate<method>([](const double x, const double y) -> double { return std::sin(x) + std::cos(y); },
+                                                        {{0.0, 10.0, 3000}, {0.0, 10.0, 3000}});
+    });
+
+    measure("separable sum ", [&]{
+        return mz::approx::riemann::approximate<method>(mz::approx::separable::sum{[](const double x){ return std::sin(x); }, [](const double y){ return std::cos(y); }},
+                                                        {{0.0, 10.0, 3000}, {0.0, 10.0, 3000}});
+    });
+
+    // expensive work which depends only on x is done once per x coordinate instead of once per grid point
+    measure("full grid     ", [&]{
+        return mz::approx::riemann::approximate<method>([](const double x, const double y) -> double {
+            return std::exp(-x) * std::pow(std::sin(x), 3) * y * y;
+        }, {{0.0, 10.0, 3000}, {0.0, 10.0, 3000}});
+    });
+
+    measure("curried       ", [&]{
+        return mz::approx::riemann::approximate<method>(mz::approx::separable::curried{[](const double x){
+            return [outer = std::exp(-x) * std::pow(std::sin(x), 3)](const double y){ return outer * y * y; };
+        }}, {{0.0, 10.0, 3000}, {0.0, 10.0, 3000}});
+    });
+
+    return 0;
+}
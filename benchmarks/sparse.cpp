@@ -0,0 +1,67 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+// compares the number of evaluations needed by Smolyak sparse grids and the mid point rule to reach the same accuracy,
+// the integrand is a smooth product of exponentials over [0, 1]^4 with the exact value (e - 1)^4
+int main() {
+
+    const auto function = [](const double x, const double y, const double z, const double v) -> double { return std::exp(x + y + z + v); };
+    const double exact = std::pow(std::exp(1.0) - 1, 4);
+
+    // the same integrand as a separable product, the mid point rule gives the same tensor sum over steps^4 points while
+    // evaluating only 4 * steps of them, which makes measuring grids far beyond 2^32 points feasible
+    const auto factor = [](const double x) -> double { return std::exp(x); };
+    const auto separable = mz::approx::separable::product(factor, factor, factor, factor);
+
+    const auto mid_point = [&](unsigned long int steps){
+        return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(separable,
+                {{0.0, 1.0, steps}, {0.0, 1.0, steps}, {0.0, 1.0, steps}, {0.0, 1.0, steps}});
+    };
+
+    const auto mid_point_error = [&](unsigned long int steps){
+        return std::fabs(mid_point(steps) - exact);
+    };
+
+    // both evaluations of the integrand agree up to rounding on grids small enough to be summed point by point
+    const auto direct = mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(function,
+            {{0.0, 1.0, 16}, {0.0, 1.0, 16}, {0.0, 1.0, 16}, {0.0, 1.0, 16}});
+    std::cout << "separable and direct mid point sums differ by " << std::fabs(direct - mid_point(16)) << std::endl;
+
+    std::cout << std::setprecision(3);
+
+    for (unsigned int level = 2; level <= 8; level++){
+        const auto sparse = mz::approx::sparse::approximate(function, {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}},
+                                                            {.max_level = level, .absolute = 0, .relative = 0});
+        const double sparse_error = std::fabs(sparse.value - exact);
+
+        // the error of the mid point rule decreases with the number of steps, the smallest number of steps per dimension
+        // which is at least as accurate is bracketed by doubling and then found by bisection
+        unsigned long int low = 0;
+        unsigned long int high = 1;
+        while (mid_point_error(high) > sparse_error){
+            low = high;
+            high *= 2;
+        }
+
+        while (high - low > 1){
+            const auto middle = low + (high - low) / 2;
+            (mid_point_error(middle) > sparse_error ? low : high) = middle;
+        }
+
+        std::cout << "level " << level << " sparse error: " << sparse_error << " evaluations: " << sparse.evaluations
+                  << " | mid point error: " << mid_point_error(high) << " evaluations: " << std::pow(static_cast<double>(high), 4) << std::endl;
+    }
+
+    const auto sequential = mz::approx::sparse::approximate(function, {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}}, {.max_level = 8, .absolute = 0, .relative = 0});
+    const auto parallel = mz::approx::sparse::approximate(mz::approx::execution::par, function, {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}}, {.max_level = 8, .absolute = 0, .relative = 0});
+    std::cout << "parallel result is " << (sequential.value == parallel.value ? "identical" : "different") << std::endl;
+
+    return 0;
+}
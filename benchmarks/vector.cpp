@@ -0,0 +1,44 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+// compares K separate passes over the grid with a single pass of a vector valued integrand, the moments of a
+// gaussian share the expensive exponential which is computed once per point in the single pass
+template <typename F>
+void measure(const char* name, F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << " moments: " << result[0] << " " << result[1] << " " << result[2] << " " << result[3]
+              << " time: " << elapsed.count() << "s" << std::endl;
+}
+
+int main() {
+
+    using method = mz::approx::riemann::method::mid_point;
+    constexpr unsigned long int steps = 2000;
+
+    measure("K passes   ", [&]{
+        std::array<double, 4> moments;
+        for (std::size_t k = 0; k < moments.size(); k++)
+            moments[k] = mz::approx::riemann::approximate<method>([k](const double x, const double y) -> double {
+                return std::pow(x, k) * std::exp(-x * x - y * y);
+            }, {{-3.0, 3.0, steps}, {-3.0, 3.0, steps}});
+        return moments;
+    });
+
+    measure("single pass", [&]{
+        return mz::approx::riemann::approximate<method>([](const double x, const double y){
+            const double density = std::exp(-x * x - y * y);
+            return std::array<double, 4>{density, x * density, x * x * density, x * x * x * density};
+        }, {{-3.0, 3.0, steps}, {-3.0, 3.0, steps}});
+    });
+
+    return 0;
+}
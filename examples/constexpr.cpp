@@ -0,0 +1,76 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include <iostream>
+#include <utility>
+#include <array>
+
+// sequential engines are usable in constant expressions as long as the integrand is, tables of integrals below are
+// computed by the compiler and checked by static_assert, nothing is integrated at run time
+
+constexpr double absolute(const double x){
+    return x < 0 ? -x : x;
+}
+
+// arctan(x) given as the integral of 1 / (1 + t^2) over [0, x], the table holds x = 0, 0.25, ..., 2
+template <std::size_t Size>
+constexpr std::array<double, Size> make_arctan_table(){
+    std::array<double, Size> table{};
+
+    for (std::size_t i = 0; i < Size; i++)
+        table[i] = mz::approx::gauss::approximate<8>([](const double t) -> double { return 1 / (1 + t * t); },
+                                                     {{0.0, 0.25 * i, 4}});
+
+    return table;
+}
+
+constexpr auto arctan_table = make_arctan_table<9>();
+
+static_assert(absolute(arctan_table[0]) < 1e-15);
+static_assert(absolute(arctan_table[4] - 0.78539816339744831) < 1e-12);
+static_assert(absolute(arctan_table[8] - 1.10714871779409050) < 1e-12);
+
+// moments of t^N over [0, 1], every entry is a separate instantiation of the integrand
+template <std::size_t N>
+constexpr double moment(){
+    return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>([](const double t) -> double {
+        double result = 1;
+        for (std::size_t power = 0; power < N; power++)
+            result *= t;
+        return result;
+    }, {{0.0, 1.0, 1000}});
+}
+
+constexpr auto moments = []<std::size_t ...N>(std::index_sequence<N...>){
+    return std::array<double, sizeof...(N)>{moment<N>()...};
+}(std::make_index_sequence<6>());
+
+static_assert(absolute(moments[0] - 1.0) < 1e-12);
+static_assert(absolute(moments[3] - 0.25) < 1e-6);
+
+// vector valued and separable integrands go through the same grid plans as at run time
+constexpr auto area_and_centroid = mz::approx::trapezoidal::approximate(
+        [](const double x, const int y) -> std::array<double, 2> { return {1.0, x * y}; }, {{0.0, 2.0, 100}, {0, 4, 4}});
+
+static_assert(absolute(area_and_centroid[0] - 8.0) < 1e-12);
+static_assert(absolute(area_and_centroid[1] - 16.0) < 1e-12);
+
+constexpr double separable_product = mz::approx::gauss::approximate<4>(
+        mz::approx::separable::product([](const double x) -> double { return x * x; }, [](const double y) -> double { return y; }),
+        {{0.0, 3.0, 1}, {0.0, 2.0, 1}});
+
+static_assert(absolute(separable_product - 18.0) < 1e-12);
+
+int main() {
+
+    for (std::size_t i = 0; i < arctan_table.size(); i++)
+        std::cout << "arctan(" << 0.25 * i << ") = " << arctan_table[i] << std::endl;
+
+    for (std::size_t n = 0; n < moments.size(); n++)
+        std::cout << "moment " << n << " = " << moments[n] << std::endl;
+
+    return 0;
+}
\ No newline at end of file
@@ -7,11 +7,88 @@
 #define APPROX_APPROX_HPP
 
 #include "../../src/internals/internals.hpp"
+#include "../../src/accumulator/accumulator.hpp"
+#include "../../src/execution/execution.hpp"
+#include "../../src/instrument/instrument.hpp"
+#include "../../src/separable/separable.hpp"
+#include "../../src/plan/plan.hpp"
 #include "../../src/riemann/riemann.hpp"
 #include "../../src/trapezoidal/trapezoidal.hpp"
+#include "../../src/adaptive/adaptive.hpp"
+#include "../../src/gauss/gauss.hpp"
+#include "../../src/montecarlo/montecarlo.hpp"
+#include "../../src/sparse/sparse.hpp"
+#include "../../src/romberg/romberg.hpp"
+#include "../../src/tanh_sinh/tanh_sinh.hpp"
+#include "../../src/io/io.hpp"
+#include "../../src/shard/shard.hpp"
+#include "../../src/async/async.hpp"
 
 namespace mz::approx {
 
+    // summation policies of the grid engines
+    namespace accumulator {
+
+        struct naive;
+
+        struct kahan;
+
+        struct kahan_neumaier;
+
+        template <typename T, std::size_t BlockSize>
+        struct blocked_pairwise;
+
+        template <std::size_t Lanes>
+        struct lanes;
+
+        struct mixed_precision;
+
+    }
+
+    // execution policies
+    namespace execution {
+
+        struct parallel_policy;
+
+    }
+
+    // opt-in instrumentation of a single integration
+    namespace instrument {
+
+        struct thread_result;
+
+        struct measurements;
+
+        template <typename Value>
+        struct result;
+
+        // used to measure an engine call made with the wrapped integrand
+        template <typename F, typename Engine>
+        auto measure(F&& function, Engine&& engine);
+
+    }
+
+    // integrands given as sums, products or curried chains of per dimension functions
+    namespace separable {
+
+        template <typename ...F>
+        struct sum;
+
+        template <typename ...F>
+        struct product;
+
+        template <typename F>
+        struct curried;
+
+    }
+
+    namespace plan {
+
+        template <typename Arg, typename ...Args>
+        class grid_plan;
+
+    }
+
     // approximate using riemann sums
     namespace riemann {
 
@@ -28,17 +105,100 @@ namespace mz::approx {
         template <typename Type>
         struct variable_integration_info;
 
+        // used to approximate functions given by any callable with arithmetic parameters
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        constexpr double approximate(F&& function, const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate functions given by a batch integrand taking blocks of first dimension coordinates as spans
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_batch_integrand, bool>>
+        constexpr double approximate(F&& function, const typename Traits::template batch_tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate functions given by a batch integrand using multiple threads
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_batch_integrand, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template batch_tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to prepare the grid of a Riemann sum once so it can be executed against many integrands
+        template <typename method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        constexpr mz::approx::plan::grid_plan<Arg, Args...> make_plan(const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info);
+
+        // used to approximate separable functions given as a sum, product or curried chain of per dimension functions
+        template <typename method, typename Accumulator, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool>>
+        constexpr double approximate(const Separable& function, const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate separable functions using multiple threads
+        template <typename method, typename Accumulator, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const Separable& function,
+                           const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate vector valued functions returning std::array in a single sweep
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_vector_integrand, bool>>
+        constexpr auto approximate(F&& function, const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate vector valued functions returning std::array using multiple threads
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_vector_integrand, bool>>
+        auto approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                         const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to approximate functions writing several outputs into a span
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_span_integrand, bool>>
+        constexpr void approximate(F&& function, const typename Traits::template span_tuple_of<mz::approx::riemann::variable_integration_info>& info, std::span<double> results);
+
+        // used to approximate functions writing several outputs into a span using multiple threads
+        template <typename method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_span_integrand, bool>>
+        void approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                         const typename Traits::template span_tuple_of<mz::approx::riemann::variable_integration_info>& info, std::span<double> results);
+
         // used to approximate functions
         template <typename method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
-        constexpr double approximate(const std::function<double(Arg, Args...)>& function,
-                                     const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info);
+        double approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info);
+
+        // used to approximate functions using multiple threads
+        template <typename method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info);
 
         // used to approximate the area under a curve given by a vector of inputs->output tuples
-        // points should be sorted in an ascending order in regards to their inputs, for now this function accepts only 1D inputs
-        // I will expand it in the future, (it already contains some code to handle them)
+        // points should be sorted in an ascending order in regards to their inputs, this function accepts only 1D inputs,
+        // gridded samples of more dimensions are handled by the overloads taking spans of axes
         template <typename method, typename Input, typename Output, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Input, Output>(), bool>>
         constexpr double approximate(const std::vector<std::tuple<std::tuple<Input>, Output>>& points);
 
+        // used to approximate the area under a curve given by separate ranges of inputs and outputs without copying them
+        template <typename method, typename InputIterator, typename OutputIterator,
+                  std::enable_if_t<std::forward_iterator<InputIterator> && std::forward_iterator<OutputIterator>, bool>>
+        constexpr double approximate(InputIterator inputs_begin, InputIterator inputs_end, OutputIterator outputs_begin);
+
+        // used to approximate the area under a curve given by spans of inputs and outputs
+        template <typename method, typename Input, typename Output,
+                  std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Input>, std::remove_const_t<Output>>(), bool>>
+        constexpr double approximate(std::span<Input> inputs, std::span<Output> outputs);
+
+        // used to approximate the area under a curve given by spans of inputs and outputs using multiple threads
+        template <typename method, typename Input, typename Output,
+                  std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Input>, std::remove_const_t<Output>>(), bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, std::span<Input> inputs, std::span<Output> outputs);
+
+        // used to approximate the volume under samples given on a tensor grid described by its axes
+        template <typename method, typename Output, typename ...Inputs,
+                  std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Output>, std::remove_const_t<Inputs>...>(), bool>>
+        double approximate(const std::tuple<std::span<Inputs>...>& axes, std::span<Output> outputs);
+
+        // used to approximate the volume under gridded samples using multiple threads
+        template <typename method, typename Output, typename ...Inputs,
+                  std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Output>, std::remove_const_t<Inputs>...>(), bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const std::tuple<std::span<Inputs>...>& axes, std::span<Output> outputs);
+
+        // used to integrate samples arriving over time with constant memory, accumulators of adjacent ranges can be merged
+        template <typename method, typename Input, typename Output>
+        class stream_accumulator;
+
     }
 
     // approximate using trapezoidal rule
@@ -47,10 +207,389 @@ namespace mz::approx {
         template <typename Type>
         struct variable_integration_info;
 
+        // used to approximate functions given by any callable with arithmetic parameters
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        constexpr double approximate(F&& function, const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate functions given by a batch integrand taking blocks of first dimension coordinates as spans
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_batch_integrand, bool>>
+        constexpr double approximate(F&& function, const typename Traits::template batch_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate functions given by a batch integrand using multiple threads
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_batch_integrand, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template batch_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to prepare the weighted grid of the trapezoidal rule once so it can be executed against many integrands
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        constexpr mz::approx::plan::grid_plan<Arg, Args...> make_plan(const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info);
+
+        // used to approximate separable functions given as a sum, product or curried chain of per dimension functions
+        template <typename Accumulator, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool>>
+        constexpr double approximate(const Separable& function, const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate separable functions using multiple threads
+        template <typename Accumulator, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const Separable& function,
+                           const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate vector valued functions returning std::array in a single sweep
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_vector_integrand, bool>>
+        constexpr auto approximate(F&& function, const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate vector valued functions returning std::array using multiple threads
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_vector_integrand, bool>>
+        auto approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                         const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info);
+
+        // used to approximate functions writing several outputs into a span
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_span_integrand, bool>>
+        constexpr void approximate(F&& function, const typename Traits::template span_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info, std::span<double> results);
+
+        // used to approximate functions writing several outputs into a span using multiple threads
+        template <typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_span_integrand, bool>>
+        void approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                         const typename Traits::template span_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info, std::span<double> results);
+
         // used to approximate functions
         template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
-        constexpr double approximate(const std::function<double(Arg, Args...)>& function,
-                                     const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info);
+        double approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info);
+
+        // used to approximate functions using multiple threads
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info);
+
+    }
+
+    // approximate using adaptive Gauss-Kronrod cubature
+    namespace adaptive {
+
+        namespace rule {
+
+            struct gauss_kronrod_15;
+
+            struct gauss_kronrod_21;
+
+        }
+
+        template <typename Type>
+        struct variable_integration_info;
+
+        struct tolerance;
+
+        struct result;
+
+        // used to approximate functions given by any callable with floating point parameters up to a given tolerance
+        template <typename Rule, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::adaptive::variable_integration_info>& info,
+                           const tolerance& limits);
+
+        // used to approximate functions up to a given tolerance
+        template <typename Rule, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::adaptive::variable_integration_info, Arg,Args...>& info,
+                           const tolerance& limits);
+
+    }
+
+    // approximate using composite Gauss-Legendre quadrature
+    namespace gauss {
+
+        template <std::size_t Order>
+        struct legendre_rule;
+
+        template <typename Type>
+        struct variable_integration_info;
+
+        // used to approximate functions given by any callable with floating point parameters
+        template <std::size_t Order, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        constexpr double approximate(F&& function, const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <std::size_t Order, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info);
+
+        // used to prepare the Gauss-Legendre grid once so it can be executed against many integrands
+        template <std::size_t Order, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        constexpr mz::approx::plan::grid_plan<Arg, Args...> make_plan(const mz::approx::internals::make_tuple_of<mz::approx::gauss::variable_integration_info, Arg,Args...>& info);
+
+        // used to approximate separable functions given as a sum, product or curried chain of per dimension functions
+        template <std::size_t Order, typename Accumulator, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool>>
+        constexpr double approximate(const Separable& function, const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::gauss::variable_integration_info>& info);
+
+        // used to approximate separable functions using multiple threads
+        template <std::size_t Order, typename Accumulator, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const Separable& function,
+                           const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::gauss::variable_integration_info>& info);
+
+        // used to approximate vector valued functions returning std::array in a single sweep
+        template <std::size_t Order, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_vector_integrand, bool>>
+        constexpr auto approximate(F&& function, const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info);
+
+        // used to approximate vector valued functions returning std::array using multiple threads
+        template <std::size_t Order, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_vector_integrand, bool>>
+        auto approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                         const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info);
+
+        // used to approximate functions writing several outputs into a span
+        template <std::size_t Order, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_span_integrand, bool>>
+        constexpr void approximate(F&& function, const typename Traits::template span_tuple_of<mz::approx::gauss::variable_integration_info>& info, std::span<double> results);
+
+        // used to approximate functions writing several outputs into a span using multiple threads
+        template <std::size_t Order, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_span_integrand, bool>>
+        void approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                         const typename Traits::template span_tuple_of<mz::approx::gauss::variable_integration_info>& info, std::span<double> results);
+
+        // used to approximate functions
+        template <std::size_t Order, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        double approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::gauss::variable_integration_info, Arg,Args...>& info);
+
+        // used to approximate functions using multiple threads
+        template <std::size_t Order, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::gauss::variable_integration_info, Arg,Args...>& info);
+
+    }
+
+    // approximate using Monte Carlo and quasi Monte Carlo sampling
+    namespace montecarlo {
+
+        namespace sequence {
+
+            struct pseudo_random;
+
+            struct sobol;
+
+            struct halton;
+
+        }
+
+        template <typename Type>
+        struct variable_integration_info;
+
+        struct settings;
+
+        struct result;
+
+        // used to approximate functions given by any callable with floating point parameters
+        template <typename Sequence, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::montecarlo::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <typename Sequence, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::montecarlo::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions
+        template <typename Sequence, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::montecarlo::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+        // used to approximate functions using multiple threads
+        template <typename Sequence, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::montecarlo::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+    }
+
+    namespace sparse {
+
+        template <typename Type>
+        struct variable_integration_info;
+
+        struct settings;
+
+        struct result;
+
+        // used to approximate functions given by any callable with floating point parameters
+        template <typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::sparse::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::sparse::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::sparse::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+        // used to approximate functions using multiple threads
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::sparse::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+    }
+
+    namespace romberg {
+
+        template <typename Type>
+        struct variable_integration_info;
+
+        struct settings;
+
+        struct result;
+
+        // used to approximate functions given by any callable with floating point parameters
+        template <typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::romberg::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::romberg::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::romberg::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+        // used to approximate functions using multiple threads
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::romberg::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+    }
+
+    namespace tanh_sinh {
+
+        template <typename Type>
+        struct variable_integration_info;
+
+        struct settings;
+
+        struct result;
+
+        // used to approximate functions with end point singularities or infinite ranges given by any callable
+        template <typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::tanh_sinh::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions given by any callable using multiple threads
+        template <typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                           const typename Traits::template tuple_of<mz::approx::tanh_sinh::variable_integration_info>& info,
+                           const settings& configuration);
+
+        // used to approximate functions
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::tanh_sinh::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+        // used to approximate functions using multiple threads
+        template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                           const mz::approx::internals::make_tuple_of<mz::approx::tanh_sinh::variable_integration_info, Arg,Args...>& info,
+                           const settings& configuration);
+
+    }
+
+    namespace io {
+
+        class mapped_file;
+
+        class sample_file;
+
+        // used to write samples in the documented sample file format
+        template <typename T, typename ...Axes>
+        void write_sample_file(const std::string& path, const std::tuple<std::span<Axes>...>& axes, std::span<const T> outputs);
+
+        // used to approximate the integral of samples stored in a memory mapped sample file
+        template <typename Method, std::size_t Dimensions, typename T>
+        double approximate(const sample_file& file);
+
+        // used to approximate the integral of samples stored in a memory mapped sample file using multiple threads
+        template <typename Method, std::size_t Dimensions, typename T>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const sample_file& file);
+
+        // used to approximate the integral of samples stored as raw little endian arrays
+        template <typename Method, typename T>
+        double approximate(const mapped_file& inputs, const mapped_file& outputs);
+
+        // used to approximate the integral of samples stored as raw little endian arrays using multiple threads
+        template <typename Method, typename T>
+        double approximate(const mz::approx::execution::parallel_policy& policy, const mapped_file& inputs, const mapped_file& outputs);
+
+    }
+
+    namespace shard {
+
+        struct job;
+
+        struct segment_state;
+
+        // used to take part in a sharded and checkpointed Riemann sum of any callable
+        template <typename Method, typename Accumulator, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+        unsigned long int run(const job& configuration, F&& function,
+                              const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info);
+
+        // used to take part in a sharded and checkpointed Riemann sum
+        template <typename Method, typename Accumulator, typename Arg, typename ...Args,
+                  std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool>>
+        unsigned long int run(const job& configuration, const std::function<double(Arg, Args...)>& function,
+                              const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info);
+
+        // used to merge the checkpoints of a finished job
+        double merge(const job& configuration);
+
+    }
+
+    namespace async {
+
+        struct estimate;
+
+        struct settings;
+
+        class progressive;
+
+        namespace riemann {
+
+            // used to approximate functions given by any callable on an executor with progressive estimates
+            template <typename Method, typename Accumulator, typename Executor, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+            progressive approximate(Executor&& executor, std::stop_token token, F&& function,
+                                    const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info,
+                                    const settings& configuration);
+
+            // used to approximate functions given by any callable on an executor using multiple threads for every pass
+            template <typename Method, typename Accumulator, typename Executor, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+            progressive approximate(Executor&& executor, std::stop_token token, const mz::approx::execution::parallel_policy& policy, F&& function,
+                                    const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info,
+                                    const settings& configuration);
+
+        }
+
+        namespace montecarlo {
+
+            // used to approximate functions given by any callable on an executor with growing numbers of samples
+            template <typename Sequence, typename Executor, typename F, typename Traits, std::enable_if_t<Traits::is_integrand, bool>>
+            progressive approximate(Executor&& executor, std::stop_token token, F&& function,
+                                    const typename Traits::template tuple_of<mz::approx::montecarlo::variable_integration_info>& info,
+                                    const mz::approx::montecarlo::settings& sampling, const settings& configuration);
+
+        }
 
     }
 
@@ -0,0 +1,264 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_ACCUMULATOR_HPP
+#define APPROX_ACCUMULATOR_HPP
+
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+#include <array>
+#include <tuple>
+#include <span>
+#include <cmath>
+
+namespace mz::approx::accumulator {
+
+    // accumulators are selected by the grid engines as a template parameter, each of them sums weighted outputs with
+    // add(value), total() gives the sum and partial() gives a (sum, compensation) tuple with the sum equal to
+    // sum - compensation, parallel engines merge the partial results of their chunks using Kahan summation, accumulators
+    // may also provide an add(values, weights, scale) used by batch integrands to add a whole block of outputs at once and
+    // a resume(partial) restoring their state from a partial result of a checkpoint
+
+    // plain running sum, the fastest one with an error growing linearly with the number of points
+    struct naive{
+        double sum = 0;
+
+        constexpr void add(double value){
+            sum += value;
+        }
+
+        constexpr double total() const{
+            return sum;
+        }
+
+        constexpr std::tuple<double, double> partial() const{
+            return {sum, 0.0};
+        }
+    };
+
+    // classic Kahan summation, the same one used to merge partial results of parallel engines
+    struct kahan{
+        std::tuple<double, double> state = {0.0, 0.0};
+
+        constexpr void add(double value){
+            state = mz::approx::internals::kahan_sum(state, value);
+        }
+
+        constexpr void resume(const std::tuple<double, double>& partial){
+            state = partial;
+        }
+
+        constexpr double total() const{
+            return std::get<0>(state) - std::get<1>(state);
+        }
+
+        constexpr std::tuple<double, double> partial() const{
+            return state;
+        }
+    };
+
+    // Kahan summation improved by Neumaier, it also keeps the low order bits of the sum when a value is larger than it
+    struct kahan_neumaier{
+        double sum = 0;
+        double compensation = 0;
+
+        constexpr void add(double value){
+            const double t = sum + value;
+            if (std::fabs(sum) >= std::fabs(value))
+                compensation += (sum - t) + value;
+            else
+                compensation += (value - t) + sum;
+            sum = t;
+        }
+
+        constexpr void resume(const std::tuple<double, double>& partial){
+            sum = std::get<0>(partial);
+            compensation = -std::get<1>(partial);
+        }
+
+        constexpr double total() const{
+            return sum + compensation;
+        }
+
+        constexpr std::tuple<double, double> partial() const{
+            return {sum, -compensation};
+        }
+    };
+
+    // sums a block in place by repeatedly adding its upper half to its lower half, the loops have no dependencies
+    // between iterations so they are vectorized, Size has to be a power of two
+    template <typename T, std::size_t Size>
+    constexpr T pairwise_block_sum(std::array<T, Size>& block){
+        static_assert(Size > 0 && (Size & (Size - 1)) == 0, "pairwise blocks have to have a power of two size");
+
+        for (std::size_t width = Size / 2; width > 0; width /= 2)
+            for (std::size_t i = 0; i < width; i++)
+                block[i] += block[i + width];
+
+        return block[0];
+    }
+
+    // blocked pairwise summation, values are gathered into blocks which are summed as balanced trees and the block sums
+    // are merged like a binary counter so the error grows with the logarithm of the number of points
+    template <typename T = double, std::size_t BlockSize = 64>
+    struct blocked_pairwise{
+        std::array<T, BlockSize> block{};
+        std::size_t count = 0;
+        // levels[i] holds the sum of 2^i blocks whenever bit i of blocks is set
+        std::array<double, 64> levels{};
+        std::uint64_t blocks = 0;
+
+        constexpr void add(double value){
+            block[count++] = static_cast<T>(value);
+            if (count == BlockSize){
+                push(static_cast<double>(pairwise_block_sum(block)));
+                block = {};
+                count = 0;
+            }
+        }
+
+        constexpr double total() const{
+            auto rest = block;
+            double result = static_cast<double>(pairwise_block_sum(rest));
+
+            for (std::size_t level = 0; level < levels.size(); level++)
+                if (blocks >> level & 1)
+                    result = levels[level] + result;
+
+            return result;
+        }
+
+        constexpr std::tuple<double, double> partial() const{
+            return {total(), 0.0};
+        }
+
+    private:
+        constexpr void push(double sum){
+            std::size_t level = 0;
+            for (auto carry = blocks; carry & 1; carry >>= 1, level++)
+                sum = levels[level] + sum;
+
+            levels[level] = sum;
+            blocks++;
+        }
+    };
+
+    using pairwise = blocked_pairwise<double>;
+
+    // sums a block of outputs in Lanes independent double lanes so consecutive additions are vectorized, weights is
+    // either empty or holds the weight of every value, float outputs are widened to double before they are added
+    template <std::size_t Lanes, typename T>
+    constexpr double lane_sum(std::span<const T> values, std::span<const double> weights){
+        std::array<double, Lanes> sums{};
+
+        // lanes are unrolled by hand so they stay in registers even when the compiler does not unroll loops
+        const auto add_lanes = [&]<std::size_t ...Lane>(std::index_sequence<Lane...>, const auto& value){
+            std::size_t index = 0;
+            for (; index + Lanes <= values.size(); index += Lanes)
+                ((sums[Lane] += value(index + Lane)), ...);
+
+            for (; index < values.size(); index++)
+                sums[0] += value(index);
+        };
+
+        if (weights.empty())
+            add_lanes(std::make_index_sequence<Lanes>(), [&](std::size_t index){ return static_cast<double>(values[index]); });
+        else
+            add_lanes(std::make_index_sequence<Lanes>(), [&](std::size_t index){ return static_cast<double>(values[index]) * weights[index]; });
+
+        double block = 0;
+        for (const auto sum : sums)
+            block += sum;
+
+        return block;
+    }
+
+    // compensated sum of blocks of outputs, every block is first summed in several independent lanes, the weights are
+    // folded into the lane sums and the block sums are added using Kahan summation, it is the default of batch
+    // integrands, single values are added like by the kahan accumulator
+    template <std::size_t Lanes = 8>
+    struct lanes{
+        std::tuple<double, double> state = {0.0, 0.0};
+
+        constexpr void add(double value){
+            state = mz::approx::internals::kahan_sum(state, value);
+        }
+
+        // scale multiplies the whole block
+        template <typename T>
+        constexpr void add(std::span<const T> values, std::span<const double> weights, double scale){
+            add(lane_sum<Lanes>(values, weights) * scale);
+        }
+
+        constexpr void resume(const std::tuple<double, double>& partial){
+            state = partial;
+        }
+
+        constexpr double total() const{
+            return std::get<0>(state) - std::get<1>(state);
+        }
+
+        constexpr std::tuple<double, double> partial() const{
+            return state;
+        }
+    };
+
+    // accumulator of batch integrands evaluated in single precision, they take std::span<const float> coordinates and
+    // write std::span<float> outputs so twice as many points fit in a vector register, every block of float outputs is
+    // summed in double lanes and the block sums are added using Kahan-Neumaier summation so only the evaluation loses
+    // precision, scalar integrands returning float are summed the same way one value at a time
+    struct mixed_precision{
+        kahan_neumaier sum;
+
+        constexpr void add(double value){
+            sum.add(value);
+        }
+
+        template <typename T>
+        constexpr void add(std::span<const T> values, std::span<const double> weights, double scale){
+            sum.add(lane_sum<8>(values, weights) * scale);
+        }
+
+        constexpr void resume(const std::tuple<double, double>& partial){
+            sum.resume(partial);
+        }
+
+        constexpr double total() const{
+            return sum.total();
+        }
+
+        constexpr std::tuple<double, double> partial() const{
+            return sum.partial();
+        }
+    };
+
+    // used by the batch engines to add a block of outputs, accumulators without a block add get the values one by one
+    template <typename Accumulator, typename T>
+    constexpr void add_block(Accumulator& accumulator, std::span<const T> values, std::span<const double> weights, double scale){
+        if constexpr (requires { accumulator.add(values, weights, scale); })
+            accumulator.add(values, weights, scale);
+        else if (weights.empty())
+            for (const auto value : values)
+                accumulator.add(static_cast<double>(value) * scale);
+        else
+            for (std::size_t index = 0; index < values.size(); index++)
+                accumulator.add(static_cast<double>(values[index]) * weights[index] * scale);
+    }
+
+    // used to continue a sum from a partial result, accumulators without resume start from sum - compensation
+    template <typename Accumulator>
+    constexpr Accumulator resume(const std::tuple<double, double>& partial){
+        Accumulator accumulator;
+        if constexpr (requires { accumulator.resume(partial); })
+            accumulator.resume(partial);
+        else
+            accumulator.add(std::get<0>(partial) - std::get<1>(partial));
+        return accumulator;
+    }
+
+}
+
+#endif
@@ -0,0 +1,258 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_ADAPTIVE_HPP
+#define APPROX_ADAPTIVE_HPP
+
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <array>
+#include <queue>
+#include <cmath>
+
+namespace mz::approx::adaptive {
+
+    namespace rule {
+
+        // embedded Gauss-Kronrod pair, nodes and weights are expanded from their non negative halves
+        // Gauss nodes are every second Kronrod node counting from the outermost one
+        template <std::size_t Half>
+        struct gauss_kronrod{
+            static constexpr std::size_t size = 2 * Half - 1;
+
+            std::array<double, size> nodes{};
+            std::array<double, size> kronrod_weights{};
+            std::array<double, size> gauss_weights{};
+
+            constexpr gauss_kronrod(const std::array<double, Half>& half_nodes, const std::array<double, Half>& half_kronrod_weights,
+                                    const std::array<double, Half / 2>& half_gauss_weights){
+
+                for (std::size_t index = 0; index < Half; index++){
+                    const auto mirrored = size - 1 - index;
+
+                    nodes[index] = -half_nodes[index];
+                    nodes[mirrored] = half_nodes[index];
+                    kronrod_weights[index] = kronrod_weights[mirrored] = half_kronrod_weights[index];
+
+                    if (index % 2)
+                        gauss_weights[index] = gauss_weights[mirrored] = half_gauss_weights[index / 2];
+                }
+            }
+        };
+
+        // 7 point Gauss rule embedded in a 15 point Kronrod rule
+        struct gauss_kronrod_15{
+            static constexpr gauss_kronrod<8> data = {
+                {0.991455371120812639206854697526329, 0.949107912342758524526189684047851, 0.864864423359769072789712788640926,
+                 0.741531185599394439863864773280788, 0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+                 0.207784955007898467600689403773245, 0.000000000000000000000000000000000},
+                {0.022935322010529224963732008058970, 0.063092092629978553290700663189204, 0.104790010322250183839876322541518,
+                 0.140653259715525918745189590510238, 0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+                 0.204432940075298892414161999234649, 0.209482141084727828012999174891714},
+                {0.129484966168869693270611432679082, 0.279705391489276667901467771423780, 0.381830050505118944950369775488975,
+                 0.417959183673469387755102040816327}
+            };
+        };
+
+        // 10 point Gauss rule embedded in a 21 point Kronrod rule
+        struct gauss_kronrod_21{
+            static constexpr gauss_kronrod<11> data = {
+                {0.995657163025808080735527280689003, 0.973906528517171720077964012084452, 0.930157491355708226001207180059508,
+                 0.865063366688984510732096688423493, 0.780817726586416897063717578345042, 0.679409568299024406234327365114874,
+                 0.562757134668604683339000099272694, 0.433395394129247190799265943165784, 0.294392862701460198131126603103866,
+                 0.148874338981631210884826001129720, 0.000000000000000000000000000000000},
+                {0.011694638867371874278064396062192, 0.032558162307964727478818972459390, 0.054755896574351996031381300244580,
+                 0.075039674810919952767043140916190, 0.093125454583697605535065465083366, 0.109387158802297641899210590325805,
+                 0.123491976262065851077548011306483, 0.134709217311473325928054001771707, 0.142775938577060080797094273138717,
+                 0.147739104901338491374841515972068, 0.149445554002916905664936468389821},
+                {0.066671344308688137593568809893332, 0.149451349150580593145776339657697, 0.219086362515982043995534934228163,
+                 0.269266719309996355091226921569469, 0.295524224714752870173892994651338}
+            };
+        };
+
+    }
+
+    template <typename Type>
+    struct variable_integration_info{
+        Type from = 0;
+        Type to = 0;
+    };
+
+    // integration stops once the error estimate drops below max(absolute, relative * |value|)
+    // or when refining further would exceed the evaluation budget
+    struct tolerance{
+        double absolute = 1e-10;
+        double relative = 1e-10;
+        unsigned long int max_evaluations = 1'000'000;
+    };
+
+    struct result{
+        double value = 0;
+        double error = 0;
+        unsigned long int evaluations = 0;
+    };
+
+    template <std::size_t Dimensions>
+    struct region{
+        std::array<double, Dimensions> centre{};
+        std::array<double, Dimensions> half_width{};
+        double value = 0;
+        double error = 0;
+
+        // dimension along which the region should be split next
+        std::size_t split_dimension = 0;
+
+        constexpr bool operator<(const region& other) const{
+            return error < other.error;
+        }
+    };
+
+    // evaluates a tensor product of the rule over the region, the Gauss rule reuses Kronrod evaluations, the error
+    // of each dimension is estimated by replacing the Kronrod weights with the Gauss ones along that dimension only
+    template <typename Rule, typename F, typename ...T>
+    region<sizeof...(T)> evaluate_region(F& function, region<sizeof...(T)> input){
+
+        constexpr auto dimensions = sizeof...(T);
+        constexpr auto& data = Rule::data;
+
+        double kronrod = 0;
+        double gauss = 0;
+        std::array<double, dimensions> partial_gauss{};
+
+        std::array<std::size_t, dimensions> position{};
+        for (bool done = false; !done;){
+
+            const auto output = [&]<size_t ...I>(std::index_sequence<I...>){
+                return static_cast<double>(function(static_cast<T>(input.centre[I] + input.half_width[I] * data.nodes[position[I]])...));
+            }(std::make_index_sequence<dimensions>());
+
+            double kronrod_weight = 1;
+            double gauss_weight = 1;
+            for (std::size_t dimension = 0; dimension < dimensions; dimension++){
+                kronrod_weight *= data.kronrod_weights[position[dimension]];
+                gauss_weight *= data.gauss_weights[position[dimension]];
+            }
+
+            kronrod += kronrod_weight * output;
+            gauss += gauss_weight * output;
+
+            // Kronrod weights are all positive so the weight of a single dimension can be divided out
+            for (std::size_t dimension = 0; dimension < dimensions; dimension++)
+                partial_gauss[dimension] += kronrod_weight / data.kronrod_weights[position[dimension]] * data.gauss_weights[position[dimension]] * output;
+
+            // advance to the next node of the tensor product
+            done = true;
+            for (std::size_t dimension = 0; dimension < dimensions; dimension++){
+                if (++position[dimension] < Rule::data.size){
+                    done = false;
+                    break;
+                }
+                position[dimension] = 0;
+            }
+        }
+
+        const double volume = std::accumulate(input.half_width.begin(), input.half_width.end(), 1.0, std::multiplies<>());
+
+        input.value = kronrod * volume;
+        input.error = std::fabs(kronrod - gauss) * volume;
+
+        std::array<double, dimensions> dimension_errors;
+        for (std::size_t dimension = 0; dimension < dimensions; dimension++)
+            dimension_errors[dimension] = std::fabs(kronrod - partial_gauss[dimension]);
+
+        input.split_dimension = std::distance(dimension_errors.begin(), std::max_element(dimension_errors.begin(), dimension_errors.end()));
+        return input;
+    }
+
+    // used to approximate functions given by any callable with floating point parameters, subregions with the largest
+    // error estimate are halved along their worst dimension until the tolerance or the evaluation budget is reached,
+    // throws if even the initial region does not fit into the budget
+    template <typename Rule = rule::gauss_kronrod_15, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::adaptive::variable_integration_info>& info,
+                       const tolerance& limits = {}){
+
+        constexpr auto dimensions = std::tuple_size_v<std::remove_cvref_t<decltype(info)>>;
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            static_assert((std::is_floating_point_v<T> && ...), "adaptive integration requires floating point variables");
+
+            const unsigned long int evaluations_per_region = std::pow(Rule::data.size, dimensions);
+
+            // even the initial region has to fit into the evaluation budget
+            if (evaluations_per_region > limits.max_evaluations)
+                throw std::runtime_error("evaluation budget is smaller than a single region of " + std::to_string(evaluations_per_region) + " points");
+
+            // check whenever we have to swap integration range
+            region<dimensions> initial;
+            std::size_t dimension = 0;
+            const auto initialize_dimension = [&](const auto& info_struct){
+                auto [from, to] = info_struct;
+                if (from > to)
+                    std::swap(from, to);
+
+                initial.centre[dimension] = std::midpoint(static_cast<double>(from), static_cast<double>(to));
+                initial.half_width[dimension++] = (static_cast<double>(to) - static_cast<double>(from)) / 2;
+            };
+            std::apply([&](const auto& ...info_struct){ (initialize_dimension(info_struct), ...); }, info_tuple);
+
+            std::priority_queue<region<dimensions>> regions;
+            regions.push(evaluate_region<Rule, F, T...>(function, initial));
+
+            result output{regions.top().value, regions.top().error, evaluations_per_region};
+
+            while (output.error > std::max(limits.absolute, limits.relative * std::fabs(output.value))
+                   && output.evaluations + 2 * evaluations_per_region <= limits.max_evaluations){
+
+                // halve the worst region along its worst dimension
+                auto worst = regions.top();
+                regions.pop();
+
+                const auto split = worst.split_dimension;
+                worst.half_width[split] /= 2;
+
+                auto lower = worst;
+                auto upper = worst;
+                lower.centre[split] -= worst.half_width[split];
+                upper.centre[split] += worst.half_width[split];
+
+                lower = evaluate_region<Rule, F, T...>(function, lower);
+                upper = evaluate_region<Rule, F, T...>(function, upper);
+
+                output.value += lower.value + upper.value - worst.value;
+                output.error += lower.error + upper.error - worst.error;
+                output.evaluations += 2 * evaluations_per_region;
+
+                regions.push(lower);
+                regions.push(upper);
+            }
+
+            // sum up the regions again to get rid of the rounding errors accumulated by the running totals
+            std::tuple<double, double> value = {0.0, 0.0};
+            std::tuple<double, double> error = {0.0, 0.0};
+            for (; !regions.empty(); regions.pop()){
+                value = mz::approx::internals::kahan_sum(value, regions.top().value);
+                error = mz::approx::internals::kahan_sum(error, regions.top().error);
+            }
+
+            output.value = std::get<0>(value) - std::get<1>(value);
+            output.error = std::get<0>(error) - std::get<1>(error);
+            return output;
+        }(info);
+    }
+
+    template <typename Rule = rule::gauss_kronrod_15, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::adaptive::variable_integration_info, Arg,Args...>& info,
+                       const tolerance& limits = {}){
+
+        return approximate<Rule>([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, limits);
+    }
+
+}
+
+#endif
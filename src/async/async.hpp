@@ -0,0 +1,367 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_ASYNC_HPP
+#define APPROX_ASYNC_HPP
+
+#include <condition_variable>
+#include <stop_token>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <limits>
+#include <future>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <tuple>
+#include <cmath>
+
+namespace mz::approx::async {
+
+    // estimate published after every finished pass, error is the difference to the previous pass for grid methods and
+    // the standard error for quasi Monte Carlo, it is infinite for the first grid pass, complete is set only by the last pass
+    struct estimate{
+        double value = 0;
+        double error = std::numeric_limits<double>::infinity();
+        unsigned long int evaluations = 0;
+        unsigned int pass = 0;
+        bool complete = false;
+    };
+
+    // thrown by the future of an integration stopped before its first pass was finished
+    class cancelled: public std::runtime_error{
+    public:
+        cancelled(): std::runtime_error("integration was stopped before the first estimate"){}
+    };
+
+    // executors are callables taking a task, this one runs every task on its own detached thread
+    struct thread_executor{
+        template <typename Task>
+        void operator()(Task&& task) const{
+            std::thread(std::forward<Task>(task)).detach();
+        }
+    };
+
+    // runs the task on the calling thread before returning, estimates are therefore final once approximate returns
+    struct inline_executor{
+        template <typename Task>
+        void operator()(Task&& task) const{
+            std::invoke(std::forward<Task>(task));
+        }
+    };
+
+    // passes is the number of coarse to fine passes, every pass halves the step sizes of the grid or doubles the number of
+    // samples, stop requests are checked after every chunk of chunk_size points, on_estimate is called from the worker
+    struct settings{
+        unsigned int passes = 5;
+        unsigned long int chunk_size = 1ul << 16;
+        std::function<void(const estimate&)> on_estimate;
+    };
+
+    // state shared by the worker and all handles of a single integration
+    class shared_state{
+    public:
+        shared_state(std::stop_token token, std::function<void(const estimate&)> callback):
+            external(std::move(token)), callback(std::move(callback)), result(promise.get_future().share()){}
+
+        bool stop_requested() const{
+            return external.stop_requested() || internal.stop_requested();
+        }
+
+        void request_stop(){
+            internal.request_stop();
+        }
+
+        // used by the passes to leave as soon as a stop was requested, the partial pass is discarded
+        void throw_if_stopped() const{
+            if (stop_requested())
+                throw stopped{};
+        }
+
+        void publish(const estimate& next){
+            {
+                std::scoped_lock lock(mutex);
+                last = next;
+            }
+
+            if (callback)
+                callback(next);
+        }
+
+        std::optional<estimate> latest() const{
+            std::scoped_lock lock(mutex);
+            return last;
+        }
+
+        // runs all passes and resolves the future with the last estimate, stopped integrations resolve with the best one
+        template <typename Passes>
+        void run(Passes& passes){
+            try {
+                passes(*this);
+            } catch (const stopped&) {
+            } catch (...) {
+                finish([&](){ promise.set_exception(std::current_exception()); });
+                return;
+            }
+
+            finish([&](){
+                if (last)
+                    promise.set_value(*last);
+                else
+                    promise.set_exception(std::make_exception_ptr(cancelled{}));
+            });
+        }
+
+        template <typename Clock, typename Duration>
+        bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const{
+            std::unique_lock lock(mutex);
+            return finished.wait_until(lock, deadline, [this](){ return done; });
+        }
+
+        const std::shared_future<estimate>& future() const{
+            return result;
+        }
+
+    private:
+        struct stopped{};
+
+        template <typename Resolve>
+        void finish(Resolve&& resolve){
+            std::scoped_lock lock(mutex);
+            resolve();
+            done = true;
+            finished.notify_all();
+        }
+
+        std::stop_token external;
+        std::stop_source internal;
+        std::function<void(const estimate&)> callback;
+
+        mutable std::mutex mutex;
+        mutable std::condition_variable finished;
+        std::optional<estimate> last;
+        bool done = false;
+
+        std::promise<estimate> promise;
+        std::shared_future<estimate> result;
+    };
+
+    // handle of an integration running on an executor, a caller bound by a deadline waits until it and takes the
+    // latest estimate, dropping the handle does not stop the integration
+    class progressive{
+    public:
+        explicit progressive(std::shared_ptr<shared_state> state): state(std::move(state)){}
+
+        std::optional<estimate> latest() const{
+            return state->latest();
+        }
+
+        bool is_ready() const{
+            return state->future().wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        // waits until all passes are finished or the deadline passes and returns the best estimate available
+        template <typename Clock, typename Duration>
+        std::optional<estimate> wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const{
+            state->wait_until(deadline);
+            return state->latest();
+        }
+
+        template <typename Rep, typename Period>
+        std::optional<estimate> wait_for(const std::chrono::duration<Rep, Period>& timeout) const{
+            return wait_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        // waits for the final estimate, throws cancelled if the integration was stopped before its first pass
+        estimate get() const{
+            return state->future().get();
+        }
+
+        const std::shared_future<estimate>& future() const{
+            return state->future();
+        }
+
+        void request_stop(){
+            state->request_stop();
+        }
+
+    private:
+        std::shared_ptr<shared_state> state;
+    };
+
+    // used to start passes(state) on the executor, the task owns copies of everything the passes captured
+    template <typename Executor, typename Passes>
+    progressive launch(Executor&& executor, std::stop_token token, const settings& configuration, Passes&& passes){
+        auto state = std::make_shared<shared_state>(std::move(token), configuration.on_estimate);
+
+        std::invoke(executor, [state, passes = std::forward<Passes>(passes)]() mutable {
+            state->run(passes);
+        });
+
+        return progressive(std::move(state));
+    }
+
+    namespace riemann {
+
+        // info of a coarser grid, the number of steps of every dimension is divided by 2^shift
+        template <typename ...T>
+        auto coarsen(const std::tuple<mz::approx::riemann::variable_integration_info<T>...>& info, unsigned int shift){
+            return std::apply([shift](const auto& ...info_struct){
+                return std::make_tuple(mz::approx::riemann::variable_integration_info<T>{
+                    info_struct.from, info_struct.to, std::max(1ul, info_struct.steps >> shift)}...);
+            }, info);
+        }
+
+        // runs coarse to fine Riemann sums, integrate(info, state) returns the sum over the grid of the given info and
+        // the number of its points, passes which would repeat the grid of the previous one are skipped
+        template <typename Integrate, typename ...T>
+        void run_passes(const std::tuple<mz::approx::riemann::variable_integration_info<T>...>& info, unsigned int passes,
+                        shared_state& state, Integrate&& integrate){
+
+            estimate output;
+            std::optional<unsigned long int> previous_size;
+            passes = std::max(1u, passes);
+
+            for (unsigned int pass = 0; pass < passes; pass++){
+                const auto pass_info = coarsen(info, passes - 1 - pass);
+                const auto [value, size] = integrate(pass_info, state);
+
+                if (previous_size == size && pass + 1 < passes)
+                    continue;
+
+                output.error = previous_size ? std::fabs(value - output.value) : std::numeric_limits<double>::infinity();
+                output.value = value;
+                output.evaluations += size;
+                output.pass = pass;
+                output.complete = pass + 1 == passes;
+                previous_size = size;
+
+                state.publish(output);
+            }
+        }
+
+        template <typename Method, typename ...T>
+        auto make_grid(const std::tuple<mz::approx::riemann::variable_integration_info<T>...>& info){
+            constexpr auto calculate_delta = [](auto&& ...dimension_data){
+                return (static_cast<double>(dimension_data.step_size) * ...);
+            };
+
+            const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+            return std::make_tuple(mz::approx::internals::grid_cursor(point_data), std::apply(calculate_delta, point_data));
+        }
+
+        // used to approximate functions given by any callable on the executor, every pass publishes an estimate and
+        // stop requests of both the token and the handle end the integration after the current chunk of points, outputs of
+        // every pass are summed by the selected accumulator
+        template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename Executor, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+                  std::enable_if_t<Traits::is_integrand, bool> = true>
+        progressive approximate(Executor&& executor, std::stop_token token, F&& function,
+                                const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info,
+                                const settings& configuration = {}){
+
+            return launch(executor, std::move(token), configuration,
+                          [function = std::forward<F>(function), info, passes = configuration.passes,
+                           chunk_size = std::max(1ul, configuration.chunk_size)](shared_state& state) mutable {
+
+                run_passes(info, passes, state, [&](const auto& pass_info, const shared_state& pass_state){
+                    const auto [grid, delta] = make_grid<Method>(pass_info);
+
+                    Accumulator result;
+                    for (unsigned long int begin = 0; begin < grid.size(); begin += chunk_size){
+                        pass_state.throw_if_stopped();
+                        grid.for_each(begin, std::min(grid.size(), begin + chunk_size), [&](const auto& ...coordinates){
+                            result.add(function(coordinates...) * delta);
+                        });
+                    }
+
+                    return std::make_tuple(result.total(), grid.size());
+                });
+            });
+        }
+
+        // used to approximate functions given by any callable on the executor, every pass is split over multiple threads
+        // and the chunks are summed by the accumulator
+        template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename Executor, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+                  std::enable_if_t<Traits::is_integrand, bool> = true>
+        progressive approximate(Executor&& executor, std::stop_token token, const mz::approx::execution::parallel_policy& policy, F&& function,
+                                const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info,
+                                const settings& configuration = {}){
+
+            auto pass_policy = policy;
+            pass_policy.chunk_size = std::max(1ul, configuration.chunk_size);
+
+            return launch(executor, std::move(token), configuration,
+                          [function = std::forward<F>(function), info, passes = configuration.passes, pass_policy](shared_state& state) mutable {
+
+                run_passes(info, passes, state, [&](const auto& pass_info, const shared_state& pass_state){
+                    const auto [grid, delta] = make_grid<Method>(pass_info);
+
+                    // stopping throws out of the chunk, the execution policy then stops handing out further chunks
+                    const double value = mz::approx::execution::reduce_chunks(pass_policy, grid.size(), [&](unsigned long int begin, unsigned long int end){
+                        pass_state.throw_if_stopped();
+
+                        Accumulator result;
+                        grid.for_each(begin, end, [&](const auto& ...coordinates){
+                            result.add(function(coordinates...) * delta);
+                        });
+                        return result.partial();
+                    });
+
+                    return std::make_tuple(value, grid.size());
+                });
+            });
+        }
+
+    }
+
+    namespace montecarlo {
+
+        // used to approximate functions given by any callable on the executor using growing numbers of quasi random
+        // samples, every pass doubles the samples of each replicate and keeps all previous ones, the final pass uses
+        // the number of samples given by the Monte Carlo settings
+        template <typename Sequence = mz::approx::montecarlo::sequence::sobol, typename Executor, typename F,
+                  typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+        progressive approximate(Executor&& executor, std::stop_token token, F&& function,
+                                const typename Traits::template tuple_of<mz::approx::montecarlo::variable_integration_info>& info,
+                                const mz::approx::montecarlo::settings& sampling = {}, const settings& configuration = {}){
+
+            return launch(executor, std::move(token), configuration,
+                          [function = std::forward<F>(function), info, sampling, passes = std::max(1u, configuration.passes),
+                           chunk_size = std::max(1ul, configuration.chunk_size)](shared_state& state) mutable {
+
+                const auto [replicates, samples_per_replicate] = mz::approx::montecarlo::split_samples<Sequence>(sampling);
+                const auto sampler = mz::approx::montecarlo::make_sampler<Sequence>(function, info, sampling);
+
+                std::vector<mz::approx::montecarlo::moments> replicate_moments(replicates);
+                unsigned long int done = 0;
+
+                for (unsigned int pass = 0; pass < passes; pass++){
+                    const auto samples = std::max(1ul, samples_per_replicate >> (passes - 1 - pass));
+                    if (samples == done && pass + 1 < passes)
+                        continue;
+
+                    for (unsigned long int replicate = 0; replicate < replicates; replicate++)
+                        for (auto begin = done; begin < samples; begin += chunk_size){
+                            state.throw_if_stopped();
+                            replicate_moments[replicate].merge(sampler(replicate, begin, std::min(samples, begin + chunk_size)));
+                        }
+                    done = samples;
+
+                    const auto pass_result = mz::approx::montecarlo::make_result<Sequence>(replicate_moments, samples, info);
+                    state.publish({pass_result.value, pass_result.standard_error, pass_result.evaluations, pass, pass + 1 == passes});
+                }
+            });
+        }
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_EXECUTION_HPP
+#define APPROX_EXECUTION_HPP
+
+#include <type_traits>
+#include <exception>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <tuple>
+
+namespace mz::approx::execution {
+
+    // selects multithreaded evaluation of the grid, the point index range is split into chunks of a fixed size
+    // which are handed out to the workers on demand, partial sums are merged in the chunk order so the result
+    // does not depend on the number of threads nor on the order in which chunks were finished
+    struct parallel_policy{
+        // 0 means use every hardware thread
+        unsigned int threads = 0;
+        unsigned long int chunk_size = 1ul << 14;
+    };
+
+    inline constexpr parallel_policy par{};
+
+    inline unsigned int number_of_threads(const parallel_policy& policy){
+        if (policy.threads)
+            return policy.threads;
+
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // split [0, total) into chunks and evaluate each of them with f(begin, end), results are returned in the chunk order
+    template <typename F>
+    auto map_chunks(const parallel_policy& policy, unsigned long int total, F&& f){
+
+        const unsigned long int chunk_size = std::max(1ul, policy.chunk_size);
+        const unsigned long int number_of_chunks = (total + chunk_size - 1) / chunk_size;
+
+        std::vector<std::invoke_result_t<F&, unsigned long int, unsigned long int>> partial_results(number_of_chunks);
+        std::atomic<unsigned long int> next_chunk = 0;
+
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        const auto worker = [&](){
+            try {
+                for (auto chunk = next_chunk++; chunk < number_of_chunks; chunk = next_chunk++){
+                    const auto begin = chunk * chunk_size;
+                    partial_results[chunk] = f(begin, std::min(total, begin + chunk_size));
+                }
+            } catch (...) {
+                // stop handing out chunks and remember the first error
+                next_chunk = number_of_chunks;
+                std::scoped_lock lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        const auto workers = std::min(static_cast<unsigned long int>(number_of_threads(policy)), number_of_chunks);
+        {
+            std::vector<std::jthread> helpers;
+            helpers.reserve(workers);
+            for (unsigned long int i = 1; i < workers; i++)
+                helpers.emplace_back(worker);
+
+            // calling thread takes part in the work as well
+            worker();
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        return partial_results;
+    }
+
+    // split [0, total) into chunks, evaluate each of them with integrate_range(begin, end) returning a Kahan
+    // (sum, compensation) tuple and merge the partial results in a fixed order
+    template <typename F>
+    double reduce_chunks(const parallel_policy& policy, unsigned long int total, F&& integrate_range){
+
+        const auto partial_sums = map_chunks(policy, total, integrate_range);
+
+        // merge (sum, compensation) pairs in the chunk order, the compensation holds the negated lost low order bits
+        const auto merge = [](const auto& result, const auto& partial){
+            const auto& [sum, compensation] = partial;
+            return mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(result, sum), -compensation);
+        };
+
+        const auto [sum, compensation] = std::accumulate(partial_sums.begin(), partial_sums.end(), std::tuple<double, double>{0.0, 0.0}, merge);
+        return sum - compensation;
+    }
+
+}
+
+#endif
@@ -0,0 +1,274 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_GAUSS_HPP
+#define APPROX_GAUSS_HPP
+
+#include <functional>
+#include <numbers>
+#include <vector>
+#include <array>
+#include <tuple>
+
+namespace mz::approx::gauss {
+
+    // nodes and weights of the Gauss-Legendre rule on [-1, 1], nodes are sorted in an ascending order
+    template <std::size_t Order>
+    struct legendre_rule{
+        std::array<double, Order> nodes{};
+        std::array<double, Order> weights{};
+    };
+
+    // cosine usable in constant expressions, only used to get initial guesses for the Newton iteration
+    constexpr double cos(double x){
+        // reduce the argument to [-pi, pi]
+        while (x > std::numbers::pi)
+            x -= 2 * std::numbers::pi;
+        while (x < -std::numbers::pi)
+            x += 2 * std::numbers::pi;
+
+        double term = 1;
+        double sum = 1;
+        for (int n = 1; n < 40; n++){
+            term *= -x * x / ((2 * n - 1) * (2 * n));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // value of the Legendre polynomial of a given order and its derivative at x, computed with the Bonnet recurrence
+    constexpr std::tuple<double, double> legendre_polynomial(std::size_t order, double x){
+        double previous = 1;
+        double current = x;
+
+        for (std::size_t n = 2; n <= order; n++){
+            const double next = ((2 * n - 1) * x * current - (n - 1) * previous) / n;
+            previous = current;
+            current = next;
+        }
+
+        const double derivative = order * (x * current - previous) / (x * x - 1);
+        return {current, derivative};
+    }
+
+    // roots of the Legendre polynomial are found with Newton iteration starting from their asymptotic approximations
+    template <std::size_t Order>
+    constexpr legendre_rule<Order> make_legendre_rule(){
+        static_assert(Order > 0, "Gauss-Legendre rule needs at least one node");
+
+        legendre_rule<Order> rule;
+
+        if constexpr (Order == 1){
+            rule.nodes[0] = 0;
+            rule.weights[0] = 2;
+            return rule;
+        }
+
+        for (std::size_t index = 0; index < (Order + 1) / 2; index++){
+            double x = gauss::cos(std::numbers::pi * (index + 0.75) / (Order + 0.5));
+
+            for (int iteration = 0; iteration < 100; iteration++){
+                const auto [value, derivative] = legendre_polynomial(Order, x);
+                const double dx = value / derivative;
+                x -= dx;
+
+                if (dx < 1e-16 && dx > -1e-16)
+                    break;
+            }
+
+            const double derivative = std::get<1>(legendre_polynomial(Order, x));
+            const double weight = 2 / ((1 - x * x) * derivative * derivative);
+
+            // roots are symmetric, the largest ones are found first
+            rule.nodes[index] = -x;
+            rule.nodes[Order - 1 - index] = x;
+            rule.weights[index] = rule.weights[Order - 1 - index] = weight;
+        }
+
+        return rule;
+    }
+
+    // tables are generated once at compile time for every order in use
+    template <std::size_t Order>
+    inline constexpr legendre_rule<Order> legendre = make_legendre_rule<Order>();
+
+    // each variable range is split into steps panels, each panel is integrated using the Gauss-Legendre rule
+    template <typename Type>
+    struct variable_integration_info{
+        Type from = 0;
+        Type to = 0;
+        const unsigned long int steps = 1;
+    };
+
+    // used to build the tensor grid of Gauss-Legendre nodes, coordinates and weights are mapped from [-1, 1] onto every panel
+    template <std::size_t Order, typename Arg, typename ...Args>
+    constexpr mz::approx::internals::grid_cursor<Arg, Args...> make_grid(const std::tuple<variable_integration_info<Arg>, variable_integration_info<Args>...>& info){
+        static_assert(std::is_floating_point_v<Arg> && (std::is_floating_point_v<Args> && ...), "Gauss-Legendre integration requires floating point variables");
+
+        constexpr auto make_tables = []<typename T>(const variable_integration_info<T>& info_struct){
+            auto [from, to, steps] = info_struct;
+
+            // check whenever we have to swap integration range
+            if (from > to)
+                std::swap(from, to);
+
+            const auto panel_size = (to - from) / steps;
+
+            std::vector<T> coordinates;
+            std::vector<double> weights;
+            coordinates.reserve(steps * Order);
+            weights.reserve(steps * Order);
+
+            for (unsigned long int panel = 0; panel < steps; panel++){
+                const auto panel_start = from + static_cast<T>(panel) * panel_size;
+
+                for (std::size_t node = 0; node < Order; node++){
+                    coordinates.push_back(static_cast<T>(panel_start + panel_size * (1 + legendre<Order>.nodes[node]) / 2));
+                    weights.push_back(static_cast<double>(panel_size) / 2 * legendre<Order>.weights[node]);
+                }
+            }
+
+            return std::make_tuple(std::move(coordinates), std::move(weights));
+        };
+
+        return std::apply([&](const auto& ...info_struct){
+            auto tables = std::make_tuple(make_tables(info_struct)...);
+
+            return [&]<size_t ...I>(std::index_sequence<I...>){
+                return mz::approx::internals::grid_cursor<Arg, Args...>(
+                        std::make_tuple(std::move(std::get<0>(std::get<I>(tables)))...),
+                        {std::move(std::get<1>(std::get<I>(tables)))...});
+            }(std::index_sequence_for<Arg, Args...>());
+        }, info);
+    }
+
+    // used to approximate functions given by any callable with floating point parameters using a tensor product
+    // of Order point Gauss-Legendre rules
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::naive, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_integrand, bool> = true>
+    constexpr double approximate(F&& function, const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info){
+
+        const auto grid = make_grid<Order>(info);
+
+        Accumulator result;
+        grid.for_each_weighted(0, grid.size(), [&](double weight, const auto& ...coordinates){
+
+            // add weighted output of the node to the result
+            result.add(function(coordinates...) * weight);
+        });
+
+        return result.total();
+    }
+
+    // used to approximate functions given by any callable using multiple threads, each chunk of the grid is summed by the
+    // accumulator and the partial sums are merged in a fixed order, results are reproducible regardless of the number of threads
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_integrand, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info){
+
+        const auto grid = make_grid<Order>(info);
+
+        const auto integrate_range = [&](unsigned long int begin, unsigned long int end){
+            Accumulator result;
+
+            grid.for_each_weighted(begin, end, [&](double weight, const auto& ...coordinates){
+                result.add(function(coordinates...) * weight);
+            });
+
+            return result.partial();
+        };
+
+        return mz::approx::execution::reduce_chunks(policy, grid.size(), integrate_range);
+    }
+
+    // used to prepare the Gauss-Legendre grid once so it can be executed against many integrands
+    template <std::size_t Order, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    constexpr mz::approx::plan::grid_plan<Arg, Args...> make_plan(const mz::approx::internals::make_tuple_of<mz::approx::gauss::variable_integration_info, Arg,Args...>& info){
+        return mz::approx::plan::grid_plan<Arg, Args...>(make_grid<Order, Arg, Args...>(info));
+    }
+
+    // used to approximate separable functions given as a separable::sum or separable::product of per dimension functions,
+    // which need only the sum of the steps evaluations, or as a separable::curried chain of per dimension stages
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool> = true>
+    constexpr double approximate(const Separable& function, const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::gauss::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Order, T...>(info_tuple).template execute<Accumulator>(function);
+        }(info);
+    }
+
+    // used to approximate separable functions using multiple threads
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const Separable& function,
+                       const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::gauss::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Order, T...>(info_tuple).template execute<Accumulator>(policy, function);
+        }(info);
+    }
+
+    // used to approximate vector valued functions returning std::array, all components are integrated in a single sweep
+    // over the grid and each of them is accumulated using its own Kahan sum
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_vector_integrand, bool> = true>
+    constexpr auto approximate(F&& function, const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Order, T...>(info_tuple).template execute<Accumulator>(function);
+        }(info);
+    }
+
+    // used to approximate vector valued functions returning std::array using multiple threads
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_vector_integrand, bool> = true>
+    auto approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                     const typename Traits::template tuple_of<mz::approx::gauss::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Order, T...>(info_tuple).template execute<Accumulator>(policy, function);
+        }(info);
+    }
+
+    // used to approximate functions writing several outputs into a span, results has to hold one entry per output
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_span_integrand, bool> = true>
+    constexpr void approximate(F&& function, const typename Traits::template span_tuple_of<mz::approx::gauss::variable_integration_info>& info, std::span<double> results){
+
+        [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            make_plan<Order, T...>(info_tuple).template execute<Accumulator>(function, results);
+        }(info);
+    }
+
+    // used to approximate functions writing several outputs into a span using multiple threads
+    template <std::size_t Order, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_span_integrand, bool> = true>
+    void approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                     const typename Traits::template span_tuple_of<mz::approx::gauss::variable_integration_info>& info, std::span<double> results){
+
+        [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            make_plan<Order, T...>(info_tuple).template execute<Accumulator>(policy, function, results);
+        }(info);
+    }
+
+    template <std::size_t Order, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    double approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::gauss::variable_integration_info, Arg,Args...>& info){
+
+        return approximate<Order>([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
+    }
+
+    // used to approximate functions using multiple threads
+    template <std::size_t Order, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::gauss::variable_integration_info, Arg,Args...>& info){
+
+        return approximate<Order>(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
+    }
+
+}
+
+#endif
@@ -0,0 +1,225 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_INSTRUMENT_HPP
+#define APPROX_INSTRUMENT_HPP
+
+#include <type_traits>
+#include <functional>
+#include <optional>
+#include <algorithm>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+namespace mz::approx::instrument {
+
+    // instrumentation is opt-in, only integrands wrapped by measure are timed and counted so engines called directly
+    // keep their plain code paths without any counters
+
+    using clock = std::chrono::steady_clock;
+
+    // work done by a single thread, busy time spans from its first integrand call to the return of its last one
+    struct thread_result{
+        std::thread::id id;
+        unsigned long int evaluations = 0;
+        clock::duration integrand_time{};
+        clock::duration busy_time{};
+    };
+
+    // counters of a whole measured call, batch integrands are counted once per call rather than once per point
+    struct measurements{
+        unsigned long int evaluations = 0;
+        clock::duration wall_time{};
+        clock::duration integrand_time{};
+        clock::duration overhead_time{};
+        std::vector<thread_result> threads;
+    };
+
+    // the value has the type returned by the engine, or its value member for engines returning a result struct which
+    // also provides the error estimate
+    template <typename Value>
+    struct result: measurements{
+        Value value{};
+        std::optional<double> error;
+    };
+
+    // engines writing their outputs into a span return nothing, only the counters are measured
+    template <>
+    struct result<void>: measurements{};
+
+    // counters of a single thread, kept apart from the public result so calls update them without conversions
+    struct thread_counters{
+        std::thread::id id;
+        unsigned long int evaluations = 0;
+        clock::duration integrand_time{};
+        clock::time_point first_call{};
+        clock::time_point last_return{};
+    };
+
+    // counters of a single measured call, each thread finds its slot once and then updates it without locking
+    class recorder{
+    public:
+        thread_counters& slot(){
+            // recorders are told apart by a process wide identifier so a slot cached by a long living thread is never
+            // reused by a later recorder created at the same address
+            thread_local unsigned long int cached_identifier = 0;
+            thread_local thread_counters* cached_slot = nullptr;
+
+            if (cached_identifier != identifier){
+                std::scoped_lock lock(mutex);
+                slots.push_back({std::this_thread::get_id(), 0, {}, {}, {}});
+                cached_identifier = identifier;
+                cached_slot = &slots.back();
+            }
+
+            return *cached_slot;
+        }
+
+        std::vector<thread_result> collect() const{
+            std::scoped_lock lock(mutex);
+
+            std::vector<thread_result> threads;
+            for (const auto& counters : slots)
+                threads.push_back({counters.id, counters.evaluations, counters.integrand_time, counters.last_return - counters.first_call});
+            return threads;
+        }
+
+    private:
+        static unsigned long int next_identifier(){
+            static std::atomic<unsigned long int> counter = 1;
+            return counter++;
+        }
+
+        mutable std::mutex mutex;
+        std::deque<thread_counters> slots;
+        const unsigned long int identifier = next_identifier();
+    };
+
+    // return and parameter types of a callable, a tuple would be ill formed for void returning callables
+    template <typename R, typename ...Args>
+    struct signature{};
+
+    template <typename F>
+    struct call_signature: call_signature<decltype(&F::operator())>{};
+
+    template <typename R, typename ...Args>
+    struct call_signature<R(*)(Args...)>{
+        using type = signature<R, Args...>;
+    };
+
+    template <typename R, typename C, typename ...Args>
+    struct call_signature<R(C::*)(Args...)>{
+        using type = signature<R, Args...>;
+    };
+
+    template <typename R, typename C, typename ...Args>
+    struct call_signature<R(C::*)(Args...) const>{
+        using type = signature<R, Args...>;
+    };
+
+    template <typename F, typename Signature = typename call_signature<std::decay_t<F>>::type>
+    class counted;
+
+    // integrand wrapper with exactly the signature of the wrapped callable, engines deduce the same traits and
+    // integration info for it as for the callable itself
+    template <typename F, typename R, typename ...Args>
+    class counted<F, signature<R, Args...>>{
+    public:
+        counted(F& function, recorder& counters): function(&function), counters(&counters){}
+
+        R operator()(Args ...args) const{
+            auto& slot = counters->slot();
+
+            const auto start = clock::now();
+            if (slot.evaluations == 0)
+                slot.first_call = start;
+
+            const auto stop = [&](){
+                slot.last_return = clock::now();
+                slot.integrand_time += slot.last_return - start;
+                slot.evaluations++;
+            };
+
+            if constexpr (std::is_void_v<R>){
+                std::invoke(*function, std::forward<Args>(args)...);
+                stop();
+            }
+            else {
+                R output = std::invoke(*function, std::forward<Args>(args)...);
+                stop();
+                return output;
+            }
+        }
+
+    private:
+        F* function;
+        recorder* counters;
+    };
+
+    // type of the value returned by an engine, engines returning a result struct provide it as its value member
+    template <typename Output>
+    struct value_of{
+        using type = Output;
+        static constexpr bool has_error = false;
+    };
+
+    template <typename Output> requires requires(const Output& output){ output.value; output.error; }
+    struct value_of<Output>{
+        using type = decltype(Output::value);
+        static constexpr bool has_error = true;
+    };
+
+    // used to measure a single integration, engine is called with the wrapped integrand and has to pass it to one of the
+    // approximate overloads, e.g. [&](auto& f){ return riemann::approximate<method::mid_point>(f, info); }, overhead time
+    // is the time spent outside of the integrand summed over all threads which took part
+    template <typename F, typename Engine>
+    auto measure(F&& function, Engine&& engine){
+        recorder counters;
+        counted<std::remove_reference_t<F>> integrand(function, counters);
+
+        using Return = std::invoke_result_t<Engine&, counted<std::remove_reference_t<F>>&>;
+        using Output = value_of<Return>;
+
+        result<typename Output::type> measured;
+        const auto start = clock::now();
+
+        if constexpr (std::is_void_v<Return>)
+            std::invoke(engine, integrand);
+        else {
+            auto output = std::invoke(engine, integrand);
+
+            if constexpr (Output::has_error){
+                measured.value = output.value;
+                measured.error = static_cast<double>(output.error);
+            }
+            else
+                measured.value = output;
+        }
+
+        const auto wall_time = clock::now() - start;
+
+        measured.wall_time = wall_time;
+        measured.threads = counters.collect();
+
+        clock::duration longest_busy_time{};
+        for (const auto& thread : measured.threads){
+            measured.evaluations += thread.evaluations;
+            measured.integrand_time += thread.integrand_time;
+            measured.overhead_time += thread.busy_time - thread.integrand_time;
+            longest_busy_time = std::max(longest_busy_time, thread.busy_time);
+        }
+        measured.overhead_time += wall_time - longest_busy_time;
+
+        return measured;
+    }
+
+}
+
+#endif
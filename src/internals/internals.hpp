@@ -7,10 +7,14 @@
 #define APPROX_INTERNALS_HPP
 
 #include <type_traits>
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <numeric>
 #include <cmath>
+#include <vector>
+#include <array>
+#include <span>
 #include <tuple>
 
 namespace mz::approx::internals {
@@ -22,11 +26,14 @@ namespace mz::approx::internals {
 
     template <typename Type>
     struct dimension_data{
-        Type current_coordinate = 0;
         Type starting_position = 0;
-        Type stop_at = 0;
         Type step_size = 0;
-        Type compensation = 0;
+        unsigned long int number_of_points = 0;
+
+        // coordinates are computed directly from the index so no rounding error is accumulated along the way
+        constexpr Type coordinate(unsigned long int index) const{
+            return static_cast<Type>(starting_position + static_cast<Type>(index) * step_size);
+        }
     };
 
     template <typename ...Tail>
@@ -86,62 +93,367 @@ namespace mz::approx::internals {
         return eq(lhs,rhs) ? true : lhs > rhs;
     }
 
-    struct greather_than{
+    template <template <typename> class W, typename ...T>
+    using make_tuple_of = typename make_internal<std::tuple, W, dummy<>, T...>::type;
+
+    // used to deduce integration variables from the parameters of a callable, generic lambdas and std::function
+    // are not recognized, the latter is handled by the dedicated overloads
+    template <typename F, typename = void>
+    struct callable_traits{
+        static constexpr bool is_integrand = false;
+        static constexpr bool is_batch_integrand = false;
+        static constexpr bool is_vector_integrand = false;
+        static constexpr bool is_span_integrand = false;
+    };
+
+    template <typename T>
+    struct batch_input{
+        static constexpr bool is_valid = false;
+        using type = void;
+    };
+
+    template <typename T>
+    struct batch_input<std::span<const T>>{
+        static constexpr bool is_valid = std::is_arithmetic_v<T>;
+        using type = T;
+    };
+
+    // the first parameter of a batch integrand is a block of coordinates of the first dimension, the remaining ones are
+    // coordinates of the other dimensions shared by the whole block
+    template <std::size_t Index, typename T>
+    struct batch_parameter{
+        static constexpr bool is_valid = std::is_arithmetic_v<T>;
+        using type = T;
+    };
+
+    template <typename T>
+    struct batch_parameter<0, T>: batch_input<T>{};
+
+    // outputs of a batch integrand are written either in double or in float, the latter are summed in double
+    template <typename T>
+    struct batch_output: std::bool_constant<std::is_same_v<T, std::span<double>> || std::is_same_v<T, std::span<float>>>{};
+
+    // batch integrands take a block of coordinates of the first dimension as std::span<const T> and scalar coordinates
+    // of the remaining dimensions, they write their outputs into the trailing std::span<double> or std::span<float> of
+    // the same length
+    template <typename Parameters, typename Indices = std::make_index_sequence<std::tuple_size_v<Parameters> - 1>>
+    struct batch_signature;
+
+    template <typename ...P, std::size_t ...I>
+    struct batch_signature<std::tuple<P...>, std::index_sequence<I...>>{
+        static constexpr bool is_batch_integrand = sizeof...(I) > 0
+                && batch_output<std::tuple_element_t<sizeof...(I), std::tuple<P...>>>::value
+                && (batch_parameter<I, std::tuple_element_t<I, std::tuple<P...>>>::is_valid && ...);
+
+        template <template <typename> class W>
+        using batch_tuple_of = make_tuple_of<W, typename batch_parameter<I, std::tuple_element_t<I, std::tuple<P...>>>::type...>;
+    };
+
+    // vector valued integrands return a std::array holding one output per component
+    template <typename T>
+    struct component_array: std::false_type{};
+
+    template <typename T, std::size_t K>
+    struct component_array<std::array<T, K>>: std::bool_constant<std::is_arithmetic_v<T> && (K > 0)>{};
 
-            template <typename T>
-            static constexpr auto compare = gt<T>;
+    // span integrands take arithmetic coordinates of a single point and write all of their outputs into the trailing
+    // std::span<double>, the number of components is given by the caller at runtime
+    template <typename Parameters, typename Indices = std::make_index_sequence<std::tuple_size_v<Parameters> - 1>>
+    struct span_signature;
 
+    template <typename ...P, std::size_t ...I>
+    struct span_signature<std::tuple<P...>, std::index_sequence<I...>>{
+        static constexpr bool is_span_integrand = sizeof...(I) > 0
+                && std::is_same_v<std::tuple_element_t<sizeof...(I), std::tuple<P...>>, std::span<double>>
+                && all_types_are_arithmetic<std::tuple_element_t<I, std::tuple<P...>>...>();
+
+        template <template <typename> class W>
+        using span_tuple_of = make_tuple_of<W, std::tuple_element_t<I, std::tuple<P...>>...>;
+    };
+
+    template <typename R, typename Arg, typename ...Args>
+    struct callable_signature: batch_signature<std::tuple<std::remove_cvref_t<Arg>, std::remove_cvref_t<Args>...>>,
+                               span_signature<std::tuple<std::remove_cvref_t<Arg>, std::remove_cvref_t<Args>...>>{
+        static constexpr bool is_integrand = all_types_are_arithmetic<std::remove_cvref_t<Arg>, std::remove_cvref_t<Args>...>()
+                && std::is_arithmetic_v<std::remove_cvref_t<R>>;
+
+        static constexpr bool is_vector_integrand = all_types_are_arithmetic<std::remove_cvref_t<Arg>, std::remove_cvref_t<Args>...>()
+                && component_array<std::remove_cvref_t<R>>::value;
+
+        template <template <typename> class W>
+        using tuple_of = make_tuple_of<W, std::remove_cvref_t<Arg>, std::remove_cvref_t<Args>...>;
     };
 
-    struct equal_greather_than{
+    template <typename R, typename ...Args>
+    struct callable_traits<R(*)(Args...)>: callable_signature<R, Args...>{};
+
+    template <typename R, typename C, typename ...Args>
+    struct callable_traits<R(C::*)(Args...)>: callable_signature<R, Args...>{};
+
+    template <typename R, typename C, typename ...Args>
+    struct callable_traits<R(C::*)(Args...) const>: callable_signature<R, Args...>{};
+
+    template <typename F>
+    struct callable_traits<F, std::void_t<decltype(&F::operator())>>: callable_traits<decltype(&F::operator())>{};
+
+    template <typename F>
+    struct is_std_function: std::false_type{};
+
+    template <typename Signature>
+    struct is_std_function<std::function<Signature>>: std::true_type{};
+
+    template <typename F>
+    using callable_traits_of = callable_traits<std::conditional_t<is_std_function<std::decay_t<F>>::value, void, std::decay_t<F>>>;
+
+    // starting position of the dimensions which are not shifted within a step
+    struct from_starting_point{
 
         template <typename T>
-        static constexpr auto compare = egt<T>;
+        static constexpr T init(const T& from, const T&){
+            return from;
+        }
 
     };
 
-    template <template <typename> class W, typename ...T>
-    using make_tuple_of = typename make_internal<std::tuple, W, dummy<>, T...>::type;
+    // random access view of a tensor grid, coordinates of every dimension are precomputed into a table
+    // points are ordered so that the first dimension changes the fastest, it is walked in a tight inner loop
+    // optionally each dimension carries a table of quadrature weights, the weight of a point is their product
+    template <typename Head, typename ...Tail>
+    class grid_cursor{
+    public:
+
+        constexpr explicit grid_cursor(const std::tuple<dimension_data<Head>, dimension_data<Tail>...>& point_data){
+            std::apply([this](const auto& ...data){
+                coordinates = std::make_tuple(make_table(data)...);
+                extents = {data.number_of_points...};
+            }, point_data);
+        }
 
-    // Apply normal summation for non floating point types
-    template <typename T, std::enable_if_t<std::negation_v<std::is_floating_point<T>>, bool> = true>
-    constexpr void advance_coordinate(dimension_data<T>& input){
-        input.current_coordinate += input.step_size;
-    }
+        // used for grids which are not evenly spaced, each dimension is given by its coordinate and weight tables
+        constexpr grid_cursor(std::tuple<std::vector<Head>, std::vector<Tail>...> coordinate_tables,
+                              std::array<std::vector<double>, 1 + sizeof...(Tail)> weight_tables):
+                coordinates(std::move(coordinate_tables)){
 
-    // Apply Kahan summation algorithm for the floating point types
-    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
-    constexpr void advance_coordinate(dimension_data<T>& input){
-        const auto y = input.step_size - input.compensation;
-        const auto t = input.current_coordinate + y;
-        input.compensation = (t - input.current_coordinate) - y;
-        input.current_coordinate = t;
-    }
+            for (std::size_t dimension = 0; dimension < weights.size(); dimension++)
+                weights[dimension] = std::move(weight_tables[dimension]);
+
+            std::apply([this](const auto& ...table){
+                extents = {table.size()...};
+            }, coordinates);
+        }
 
-    template <typename Comparator>
-    constexpr void advance_to_next_point(){}
+        // weight_rule(dimension_data, index) gives the weight of a point along a single dimension
+        template <typename WeightRule>
+        constexpr grid_cursor(const std::tuple<dimension_data<Head>, dimension_data<Tail>...>& point_data, WeightRule&& weight_rule): grid_cursor(point_data){
+            std::size_t dimension = 0;
 
-    template <typename Comparator, typename Head, typename ...Tail>
-    constexpr void advance_to_next_point(dimension_data<Head>& head, dimension_data<Tail>& ...tail){
-        advance_coordinate(head);
+            std::apply([&](const auto& ...data){
+                ((weights[dimension++] = make_weights(data, weight_rule)), ...);
+            }, point_data);
+        }
 
-        if (Comparator::template compare<Head>(head.current_coordinate, head.stop_at)){
-            head.current_coordinate = head.starting_position;
-            head.compensation = 0;
+        constexpr unsigned long int size() const{
+            return std::accumulate(extents.begin(), extents.end(), 1ul, std::multiplies<>());
+        }
 
-            advance_to_next_point<Comparator>(tail...);
+        // grids with an empty first dimension have no rows
+        constexpr unsigned long int number_of_rows() const{
+            return extents.front() == 0 ? 0 : size() / extents.front();
+        }
+
+        constexpr unsigned long int row_size() const{
+            return extents.front();
+        }
+
+        constexpr bool is_weighted() const{
+            return !weights.front().empty();
+        }
+
+        // coordinates of a single dimension
+        template <std::size_t Dimension>
+        constexpr auto axis() const{
+            using type = std::tuple_element_t<Dimension, std::tuple<Head, Tail...>>;
+            return std::span<const type>(std::get<Dimension>(coordinates));
+        }
+
+        // weight of a coordinate along a single dimension, grids without weights give 1
+        constexpr double axis_weight(std::size_t dimension, unsigned long int index) const{
+            return is_weighted() ? weights[dimension][index] : 1.0;
+        }
+
+        // coordinates of the point with a given linear index
+        constexpr std::tuple<Head, Tail...> point(unsigned long int index) const{
+            return [&]<size_t ...I>(std::index_sequence<I...>){
+                std::array<unsigned long int, sizeof...(I)> position;
+                ((position[I] = index % extents[I], index /= extents[I]), ...);
+                return std::tuple<Head, Tail...>(std::get<I>(coordinates)[position[I]]...);
+            }(std::index_sequence_for<Head, Tail...>());
+        }
+
+        // calls f(inner, tail...) for every row segment of the points in [begin, end), inner holds the first dimension
+        // coordinates of the segment and tail the coordinates of the remaining dimensions shared by the whole segment
+        template <typename F>
+        constexpr void for_each_segment(unsigned long int begin, unsigned long int end, F&& f) const{
+            visit_segments(begin, end, [&](unsigned long int offset, unsigned long int count, const auto& position){
+                [&]<size_t ...I>(std::index_sequence<I...>){
+                    f(inner_coordinates(offset, count), std::get<I + 1>(coordinates)[position[I]]...);
+                }(std::index_sequence_for<Tail...>());
+            });
+        }
+
+        // same as for_each_segment but calls f(inner, inner_weights, outer_weight, tail...), outer_weight is the product
+        // of the weights of the remaining dimensions, for grids without weights inner_weights is empty and outer_weight is 1
+        template <typename F>
+        constexpr void for_each_weighted_segment(unsigned long int begin, unsigned long int end, F&& f) const{
+            visit_segments(begin, end, [&](unsigned long int offset, unsigned long int count, const auto& position){
+                [&]<size_t ...I>(std::index_sequence<I...>){
+                    if (!is_weighted())
+                        return f(inner_coordinates(offset, count), std::span<const double>(), 1.0, std::get<I + 1>(coordinates)[position[I]]...);
+
+                    const double outer_weight = (1.0 * ... * weights[I + 1][position[I]]);
+                    f(inner_coordinates(offset, count), std::span<const double>(weights.front().data() + offset, count), outer_weight,
+                      std::get<I + 1>(coordinates)[position[I]]...);
+                }(std::index_sequence_for<Tail...>());
+            });
+        }
+
+        // calls f(inner, tail...) for every whole row in [first_row, last_row)
+        template <typename F>
+        constexpr void for_each_row(unsigned long int first_row, unsigned long int last_row, F&& f) const{
+            for_each_segment(first_row * extents.front(), last_row * extents.front(), std::forward<F>(f));
+        }
+
+        // calls f(head, tail...) for every point in [begin, end)
+        template <typename F>
+        constexpr void for_each(unsigned long int begin, unsigned long int end, F&& f) const{
+            for_each_segment(begin, end, [&f](std::span<const Head> inner, const Tail& ...tail){
+                for (const auto& head : inner)
+                    f(head, tail...);
+            });
+        }
+
+        // calls f(weight, head, tail...) for every point in [begin, end)
+        template <typename F>
+        constexpr void for_each_weighted(unsigned long int begin, unsigned long int end, F&& f) const{
+            for_each_weighted_segment(begin, end, [&f](std::span<const Head> inner, std::span<const double> inner_weights, double outer_weight, const Tail& ...tail){
+                for (std::size_t index = 0; index < inner.size(); index++)
+                    f(inner_weights.empty() ? outer_weight : inner_weights[index] * outer_weight, inner[index], tail...);
+            });
+        }
+
+    private:
+
+        template <typename T>
+        static constexpr std::vector<T> make_table(const dimension_data<T>& data){
+            std::vector<T> table(data.number_of_points);
+            for (unsigned long int index = 0; index < data.number_of_points; index++)
+                table[index] = data.coordinate(index);
+            return table;
         }
-    }
 
-    template <class F, typename Head, typename ...Tail>
-    struct bind_function_parameters{
-        F f;
+        template <typename T, typename WeightRule>
+        static constexpr std::vector<double> make_weights(const dimension_data<T>& data, WeightRule& weight_rule){
+            std::vector<double> table(data.number_of_points);
+            for (unsigned long int index = 0; index < data.number_of_points; index++)
+                table[index] = weight_rule(data, index);
+            return table;
+        }
+
+        constexpr std::span<const Head> inner_coordinates(unsigned long int offset, unsigned long int count) const{
+            return std::span<const Head>(std::get<0>(coordinates).data() + offset, count);
+        }
 
-        constexpr auto operator()(const dimension_data<Head>& head, const dimension_data<Tail>& ...tail){
-            return std::bind_front(f, head.current_coordinate, (tail.current_coordinate)...);
+        // calls f(offset, count, position) for every row segment of the points in [begin, end), offset and count describe
+        // the segment within the first dimension while position holds indices of the remaining dimensions
+        template <typename F>
+        constexpr void visit_segments(unsigned long int begin, unsigned long int end, F&& f) const{
+            if (begin >= end)
+                return;
+
+            auto offset = begin % extents.front();
+
+            // decompose the row index into the positions of the remaining dimensions
+            std::array<unsigned long int, sizeof...(Tail)> position{};
+            auto row = begin / extents.front();
+            for (std::size_t dimension = 0; dimension < sizeof...(Tail); dimension++){
+                position[dimension] = row % extents[dimension + 1];
+                row /= extents[dimension + 1];
+            }
+
+            while (begin < end){
+                const auto count = std::min(extents.front() - offset, end - begin);
+                f(offset, count, position);
+
+                begin += count;
+                offset = 0;
+
+                // advance positions of the remaining dimensions
+                for (std::size_t dimension = 0; dimension < sizeof...(Tail); dimension++){
+                    if (++position[dimension] < extents[dimension + 1])
+                        break;
+                    position[dimension] = 0;
+                }
+            }
         }
+
+        std::tuple<std::vector<Head>, std::vector<Tail>...> coordinates;
+        std::array<unsigned long int, 1 + sizeof...(Tail)> extents{};
+        // a vector rather than an array of tables, implicitly moving an array of vectors frees its tables twice in
+        // constant expressions with GCC
+        std::vector<std::vector<double>> weights = std::vector<std::vector<double>>(1 + sizeof...(Tail));
     };
 
+    // number of points handed to a batch integrand at once
+    inline constexpr std::size_t batch_size = 256;
+
+    // used to select the type of the outputs of a batch integrand, generic callables are handled as well
+    template <typename F, typename Head, typename ...Tail>
+    using batch_output_of = std::conditional_t<std::is_invocable_v<F&, std::span<const Head>, const Tail&..., std::span<double>>, double, float>;
+
+    // evaluates a batch integrand on the points [begin, end) of a grid, blocks of the first dimension coordinates are taken
+    // directly from the grid while the remaining coordinates are constant along a row so they are passed as scalars and
+    // the integrand can hoist the work depending only on them out of its loop, consume(outputs, weights, outer_weight)
+    // receives every block of outputs with the first dimension weights of its points and the product of the remaining
+    // weights, weights is empty for grids without weights, outputs are double or float as declared by the integrand
+    template <typename F, typename Consume, typename Head, typename ...Tail>
+    constexpr void for_each_batch(const grid_cursor<Head, Tail...>& grid, unsigned long int begin, unsigned long int end, F&& function, Consume&& consume){
+        using Output = batch_output_of<std::remove_reference_t<F>, Head, Tail...>;
+        std::array<Output, batch_size> outputs{};
+
+        grid.for_each_weighted_segment(begin, end, [&](std::span<const Head> inner, std::span<const double> inner_weights, double outer_weight, const Tail& ...tail){
+            for (std::size_t offset = 0; offset < inner.size(); offset += batch_size){
+                const auto count = std::min(inner.size() - offset, batch_size);
+                const auto output = std::span<Output>(outputs.data(), count);
+
+                function(inner.subspan(offset, count), tail..., output);
+                consume(std::span<const Output>(output), inner_weights.empty() ? inner_weights : inner_weights.subspan(offset, count), outer_weight);
+            }
+        });
+    }
+
+    // used to initialize dimension data from the integration info, Method selects the starting position within a step
+    template <typename Method, typename ...T, template <typename> class Info>
+    constexpr auto initialize_point_data(const std::tuple<Info<T>...>& info){
+
+        constexpr auto initialize_dimension_data = []<typename D>(const Info<D>& info_struct){
+            dimension_data<D> data;
+            auto [from, to, steps] = info_struct;
+
+            // check whenever we have to swap integration range
+            if (from > to)
+                std::swap(from, to);
+
+            data.step_size = (to - from) / steps;
+            data.starting_position = Method::init(from, data.step_size);
+            data.number_of_points = steps;
+            return data;
+        };
+
+        return std::apply([&](const auto& ...info_struct){
+            return std::make_tuple(initialize_dimension_data(info_struct)...);
+        }, info);
+    }
+
     template <typename F, size_t Index>
     constexpr auto zip_with_helper(F&& f, const auto&... i){
         return f(std::get<Index>(i)...);
@@ -0,0 +1,297 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_IO_HPP
+#define APPROX_IO_HPP
+
+#include <system_error>
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <string>
+#include <vector>
+#include <array>
+#include <span>
+#include <bit>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace mz::approx::io {
+
+    // sample files are little endian and consist of a header followed by contiguous columns:
+    //
+    //   offset  size                 field
+    //   0       8                    magic, the characters "APXSMPL1"
+    //   8       4                    dtype, 0 for float64 and 1 for float32 columns
+    //   12      4                    dimensions, number of input axes D
+    //   16      8 * D                extents, number of coordinates along each axis
+    //   16+8*D  extent_i * size      one column of sorted coordinates per axis
+    //   ...     prod(extents) * size column of outputs, the first axis varies the fastest
+    //
+    // with a single dimension the file holds plain samples, inputs followed by outputs of the same length,
+    // with more dimensions it holds samples of a tensor grid, the header size keeps all columns 8 byte aligned
+    inline constexpr std::array<char, 8> sample_file_magic = {'A', 'P', 'X', 'S', 'M', 'P', 'L', '1'};
+
+    enum class dtype : std::uint32_t{
+        float64 = 0,
+        float32 = 1
+    };
+
+    template <typename T>
+    constexpr dtype dtype_of(){
+        static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "sample files hold only float64 or float32 columns");
+        return std::is_same_v<T, double> ? dtype::float64 : dtype::float32;
+    }
+
+    constexpr std::size_t dtype_size(dtype type){
+        return type == dtype::float64 ? sizeof(double) : sizeof(float);
+    }
+
+    // read only memory mapping of a whole file, the kernel is told that pages will be read sequentially
+    class mapped_file{
+    public:
+        explicit mapped_file(const std::string& path){
+            if constexpr (std::endian::native != std::endian::little)
+                throw std::runtime_error("mapped files are little endian, big endian hosts are not supported");
+
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+            if (descriptor < 0)
+                throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+            struct stat status{};
+            if (::fstat(descriptor, &status) < 0){
+                const int error = errno;
+                ::close(descriptor);
+                throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+            }
+
+            size = static_cast<std::size_t>(status.st_size);
+            if (size > 0){
+                address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (address == MAP_FAILED){
+                    const int error = errno;
+                    ::close(descriptor);
+                    throw std::system_error(error, std::generic_category(), "cannot map " + path);
+                }
+
+                // only a hint, integration still works if the kernel ignores it
+                ::madvise(address, size, MADV_SEQUENTIAL);
+            }
+
+            // the mapping stays valid after the descriptor is closed
+            ::close(descriptor);
+        }
+
+        mapped_file(mapped_file&& other) noexcept : address(std::exchange(other.address, nullptr)), size(std::exchange(other.size, 0)){}
+
+        mapped_file& operator=(mapped_file&& other) noexcept{
+            std::swap(address, other.address);
+            std::swap(size, other.size);
+            return *this;
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file(){
+            if (address != nullptr)
+                ::munmap(address, size);
+        }
+
+        std::span<const std::byte> bytes() const{
+            return {static_cast<const std::byte*>(address), size};
+        }
+
+        // whole file viewed as a raw little endian array, trailing bytes which do not form a whole value are ignored
+        template <typename T>
+        std::span<const T> as() const{
+            static_assert(std::is_arithmetic_v<T>, "mapped files can be viewed only as arrays of arithmetic values");
+            return {static_cast<const T*>(address), size / sizeof(T)};
+        }
+
+    private:
+        void* address = nullptr;
+        std::size_t size = 0;
+    };
+
+    // memory mapped sample file, columns are exposed as spans pointing directly into the mapping
+    class sample_file{
+    public:
+        explicit sample_file(const std::string& path) : file(path){
+            const auto bytes = file.bytes();
+
+            if (bytes.size() < 16 || std::memcmp(bytes.data(), sample_file_magic.data(), sample_file_magic.size()) != 0)
+                throw std::runtime_error(path + " is not a sample file");
+
+            std::uint32_t type = 0;
+            std::uint32_t dimensions = 0;
+            std::memcpy(&type, bytes.data() + 8, sizeof(type));
+            std::memcpy(&dimensions, bytes.data() + 12, sizeof(dimensions));
+
+            if (type > static_cast<std::uint32_t>(dtype::float32) || dimensions == 0)
+                throw std::runtime_error(path + " has an invalid header");
+
+            const std::size_t header_size = 16 + 8 * std::size_t(dimensions);
+            if (bytes.size() < header_size)
+                throw std::runtime_error(path + " is truncated");
+
+            column_type = static_cast<dtype>(type);
+            extents.resize(dimensions);
+            std::memcpy(extents.data(), bytes.data() + 16, 8 * std::size_t(dimensions));
+
+            // extents come straight from the file, every size derived from them is checked for overflow so a malformed
+            // header cannot wrap the offsets around and pass the truncation check
+            const auto multiply = [&](std::size_t left, std::uint64_t right){
+                if (right != 0 && left > std::numeric_limits<std::size_t>::max() / right)
+                    throw std::runtime_error(path + " has an invalid header");
+                return left * static_cast<std::size_t>(right);
+            };
+
+            const auto add = [&](std::size_t left, std::size_t right){
+                if (left > std::numeric_limits<std::size_t>::max() - right)
+                    throw std::runtime_error(path + " has an invalid header");
+                return left + right;
+            };
+
+            // find the offsets of all columns, the outputs follow the last axis
+            std::size_t offset = header_size;
+            number_of_outputs = 1;
+            for (const auto extent : extents){
+                offsets.push_back(offset);
+                offset = add(offset, multiply(dtype_size(column_type), extent));
+                number_of_outputs = multiply(number_of_outputs, extent);
+            }
+            offsets.push_back(offset);
+            offset = add(offset, multiply(dtype_size(column_type), number_of_outputs));
+
+            if (bytes.size() < offset)
+                throw std::runtime_error(path + " is truncated");
+        }
+
+        dtype type() const{
+            return column_type;
+        }
+
+        std::size_t dimensions() const{
+            return extents.size();
+        }
+
+        std::size_t extent(std::size_t dimension) const{
+            return extents[dimension];
+        }
+
+        // coordinates of a single axis, T has to match the dtype of the file
+        template <typename T>
+        std::span<const T> axis(std::size_t dimension) const{
+            return column<T>(dimension, extents[dimension]);
+        }
+
+        // outputs of all samples, T has to match the dtype of the file
+        template <typename T>
+        std::span<const T> outputs() const{
+            return column<T>(extents.size(), number_of_outputs);
+        }
+
+    private:
+        template <typename T>
+        std::span<const T> column(std::size_t index, std::size_t count) const{
+            if (dtype_of<T>() != column_type)
+                throw std::runtime_error("requested column type does not match the dtype of the sample file");
+
+            return {reinterpret_cast<const T*>(file.bytes().data() + offsets[index]), count};
+        }
+
+        mapped_file file;
+        dtype column_type = dtype::float64;
+        std::vector<std::uint64_t> extents;
+        std::vector<std::size_t> offsets;
+        std::size_t number_of_outputs = 0;
+    };
+
+    // writes a sample file, the number of outputs has to be equal to the product of the axis lengths
+    template <typename T, typename ...Axes>
+    void write_sample_file(const std::string& path, const std::tuple<std::span<Axes>...>& axes, std::span<const T> outputs){
+        static_assert((std::is_same_v<std::remove_const_t<Axes>, T> && ...), "all columns of a sample file have the same dtype");
+
+        if constexpr (std::endian::native != std::endian::little)
+            throw std::runtime_error("sample files are little endian, big endian hosts are not supported");
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            throw std::system_error(errno, std::generic_category(), "cannot create " + path);
+
+        const auto type = static_cast<std::uint32_t>(dtype_of<T>());
+        const auto dimensions = static_cast<std::uint32_t>(sizeof...(Axes));
+
+        stream.write(sample_file_magic.data(), sample_file_magic.size());
+        stream.write(reinterpret_cast<const char*>(&type), sizeof(type));
+        stream.write(reinterpret_cast<const char*>(&dimensions), sizeof(dimensions));
+
+        std::apply([&](const auto& ...axis){
+            const std::array<std::uint64_t, sizeof...(Axes)> extents = {axis.size()...};
+            stream.write(reinterpret_cast<const char*>(extents.data()), sizeof(extents));
+            (stream.write(reinterpret_cast<const char*>(axis.data()), axis.size_bytes()), ...);
+        }, axes);
+
+        stream.write(reinterpret_cast<const char*>(outputs.data()), outputs.size_bytes());
+
+        if (!stream)
+            throw std::system_error(errno, std::generic_category(), "cannot write " + path);
+    }
+
+    // used to approximate the integral of samples stored in a sample file, columns are passed to the sample integrator
+    // as spans into the mapping so nothing proportional to the file size is allocated, the file has to have Dimensions axes
+    template <typename Method, std::size_t Dimensions = 1, typename T = double>
+    double approximate(const sample_file& file){
+
+        if (file.dimensions() != Dimensions)
+            throw std::runtime_error("number of dimensions of the sample file does not match the requested one");
+
+        // plain samples are integrated pair by pair, axis weights are only allocated for gridded samples
+        if constexpr (Dimensions == 1)
+            return mz::approx::riemann::approximate<Method>(file.axis<T>(0), file.outputs<T>());
+        else
+            return [&]<size_t ...I>(std::index_sequence<I...>){
+                return mz::approx::riemann::approximate<Method>(std::make_tuple(file.axis<T>(I)...), file.outputs<T>());
+            }(std::make_index_sequence<Dimensions>());
+    }
+
+    // used to approximate the integral of samples stored in a sample file using multiple threads
+    template <typename Method, std::size_t Dimensions = 1, typename T = double>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const sample_file& file){
+
+        if (file.dimensions() != Dimensions)
+            throw std::runtime_error("number of dimensions of the sample file does not match the requested one");
+
+        if constexpr (Dimensions == 1)
+            return mz::approx::riemann::approximate<Method>(policy, file.axis<T>(0), file.outputs<T>());
+        else
+            return [&]<size_t ...I>(std::index_sequence<I...>){
+                return mz::approx::riemann::approximate<Method>(policy, std::make_tuple(file.axis<T>(I)...), file.outputs<T>());
+            }(std::make_index_sequence<Dimensions>());
+    }
+
+    // used to approximate the integral of samples stored as two raw little endian arrays, one of inputs and one of outputs
+    template <typename Method, typename T = double>
+    double approximate(const mapped_file& inputs, const mapped_file& outputs){
+        return mz::approx::riemann::approximate<Method>(inputs.as<T>(), outputs.as<T>());
+    }
+
+    // used to approximate the integral of samples stored as two raw little endian arrays using multiple threads
+    template <typename Method, typename T = double>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const mapped_file& inputs, const mapped_file& outputs){
+        return mz::approx::riemann::approximate<Method>(policy, inputs.as<T>(), outputs.as<T>());
+    }
+
+}
+
+#endif
@@ -0,0 +1,355 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_MONTECARLO_HPP
+#define APPROX_MONTECARLO_HPP
+
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <cmath>
+
+namespace mz::approx::montecarlo {
+
+    // counter based generator, the same (seed, stream, counter) always gives the same bits so samples can be generated
+    // in any order and on any thread, it is built from the SplitMix64 finalizer
+    constexpr std::uint64_t mix(std::uint64_t value){
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    constexpr std::uint64_t random_bits(std::uint64_t seed, std::uint64_t stream, std::uint64_t counter){
+        return mix(mix(mix(seed) ^ stream) ^ counter);
+    }
+
+    // uniformly distributed double in [0, 1)
+    constexpr double random_uniform(std::uint64_t seed, std::uint64_t stream, std::uint64_t counter){
+        return static_cast<double>(random_bits(seed, stream, counter) >> 11) * 0x1.0p-53;
+    }
+
+    struct sobol_polynomial{
+        unsigned int degree;
+        unsigned int coefficients;
+        std::array<std::uint32_t, 8> initial_numbers;
+    };
+
+    // primitive polynomials and initial direction numbers of Joe and Kuo for the dimensions past the first one
+    inline constexpr std::array<sobol_polynomial, 20> sobol_polynomials = {{
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}},
+        {5, 14, {1, 3, 5, 5, 31}},
+        {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}},
+        {6, 16, {1, 3, 1, 13, 27, 49}},
+        {6, 19, {1, 1, 1, 15, 7, 5}},
+        {6, 22, {1, 3, 1, 15, 13, 25}},
+        {6, 25, {1, 1, 5, 5, 19, 61}},
+        {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+        {7, 4, {1, 3, 7, 13, 13, 15, 69}}
+    }};
+
+    inline constexpr std::size_t sobol_bits = 32;
+    inline constexpr std::size_t sobol_max_dimensions = sobol_polynomials.size() + 1;
+
+    using sobol_directions = std::array<std::array<std::uint32_t, sobol_bits>, sobol_max_dimensions>;
+
+    constexpr sobol_directions make_sobol_directions(){
+        sobol_directions directions{};
+
+        // the first dimension is the van der Corput sequence in base 2
+        for (std::size_t bit = 0; bit < sobol_bits; bit++)
+            directions[0][bit] = std::uint32_t(1) << (sobol_bits - 1 - bit);
+
+        for (std::size_t dimension = 1; dimension < sobol_max_dimensions; dimension++){
+            const auto& [degree, coefficients, initial_numbers] = sobol_polynomials[dimension - 1];
+            auto& v = directions[dimension];
+
+            for (std::size_t bit = 0; bit < sobol_bits; bit++){
+                if (bit < degree){
+                    v[bit] = initial_numbers[bit] << (sobol_bits - 1 - bit);
+                    continue;
+                }
+
+                v[bit] = v[bit - degree] ^ (v[bit - degree] >> degree);
+                for (std::size_t k = 1; k < degree; k++)
+                    v[bit] ^= ((coefficients >> (degree - 1 - k)) & 1) * v[bit - k];
+            }
+        }
+
+        return directions;
+    }
+
+    constexpr bool is_prime(unsigned int value){
+        for (unsigned int divisor = 2; divisor * divisor <= value; divisor++)
+            if (value % divisor == 0)
+                return false;
+        return value > 1;
+    }
+
+    template <std::size_t Count>
+    constexpr std::array<unsigned int, Count> make_primes(){
+        std::array<unsigned int, Count> primes{};
+        for (unsigned int candidate = 2, found = 0; found < Count; candidate++)
+            if (is_prime(candidate))
+                primes[found++] = candidate;
+        return primes;
+    }
+
+    namespace sequence {
+
+        // independent pseudo random samples, the error is estimated from the sample variance
+        struct pseudo_random{
+            static constexpr bool is_randomized = false;
+            static constexpr std::size_t max_dimensions = std::numeric_limits<std::size_t>::max();
+            static constexpr unsigned long int max_samples = std::numeric_limits<unsigned long int>::max();
+
+            static constexpr double sample(std::uint64_t index, std::size_t dimension, std::uint64_t seed, std::uint64_t replicate){
+                return random_uniform(seed, replicate * 0x100000000ull + dimension, index);
+            }
+        };
+
+        // Sobol low discrepancy sequence randomized with a digital shift per replicate
+        struct sobol{
+            static constexpr bool is_randomized = true;
+            static constexpr std::size_t max_dimensions = sobol_max_dimensions;
+            // direction numbers have 32 bits so indices of a replicate have to fit into 32 bits as well
+            static constexpr unsigned long int max_samples = 1ul << 32;
+
+            static constexpr sobol_directions directions = make_sobol_directions();
+
+            static constexpr double sample(std::uint64_t index, std::size_t dimension, std::uint64_t seed, std::uint64_t replicate){
+                auto bits = static_cast<std::uint32_t>(random_bits(seed, replicate, dimension) >> 32);
+                for (std::size_t bit = 0; index; bit++, index >>= 1)
+                    if (index & 1)
+                        bits ^= directions[dimension][bit];
+                return static_cast<double>(bits) * 0x1.0p-32;
+            }
+        };
+
+        // Halton low discrepancy sequence randomized with a random shift modulo 1 per replicate
+        struct halton{
+            static constexpr bool is_randomized = true;
+            static constexpr std::size_t max_dimensions = 64;
+            static constexpr unsigned long int max_samples = std::numeric_limits<unsigned long int>::max();
+
+            static constexpr std::array<unsigned int, max_dimensions> bases = make_primes<max_dimensions>();
+
+            static double sample(std::uint64_t index, std::size_t dimension, std::uint64_t seed, std::uint64_t replicate){
+                const auto base = bases[dimension];
+
+                // radical inverse of the index, the point at zero is skipped
+                double result = 0;
+                double scale = 1.0 / base;
+                for (auto value = index + 1; value; value /= base, scale /= base)
+                    result += static_cast<double>(value % base) * scale;
+
+                result += random_uniform(seed, replicate, dimension);
+                return result - std::floor(result);
+            }
+        };
+
+    }
+
+    template <typename Type>
+    struct variable_integration_info{
+        Type from = 0;
+        Type to = 0;
+    };
+
+    // randomized sequences split the samples into replicates, each one shifted independently, and estimate the error
+    // from the spread of their results, pseudo random sampling ignores replicates and uses the sample variance instead
+    struct settings{
+        unsigned long int samples = 1ul << 16;
+        unsigned long int replicates = 16;
+        std::uint64_t seed = 0;
+    };
+
+    struct result{
+        double value = 0;
+        double standard_error = 0;
+        unsigned long int evaluations = 0;
+    };
+
+    // compensated sums of outputs and their squares over a batch of samples
+    struct moments{
+        std::tuple<double, double> sum = {0.0, 0.0};
+        std::tuple<double, double> sum_of_squares = {0.0, 0.0};
+
+        constexpr void add(double value){
+            sum = mz::approx::internals::kahan_sum(sum, value);
+            sum_of_squares = mz::approx::internals::kahan_sum(sum_of_squares, value * value);
+        }
+
+        constexpr void merge(const moments& other){
+            sum = mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(sum, std::get<0>(other.sum)), -std::get<1>(other.sum));
+            sum_of_squares = mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(sum_of_squares, std::get<0>(other.sum_of_squares)),
+                                                              -std::get<1>(other.sum_of_squares));
+        }
+
+        constexpr double total() const{
+            return std::get<0>(sum) - std::get<1>(sum);
+        }
+
+        constexpr double total_of_squares() const{
+            return std::get<0>(sum_of_squares) - std::get<1>(sum_of_squares);
+        }
+    };
+
+    // evaluates the samples [begin, end) of a single replicate, map_batch(begin, end) gives the moments of a batch
+    // of samples, it is either called directly or distributed over threads by the execution policy
+    template <typename Sequence, typename F, typename ...T>
+    auto make_sampler(F& function, const std::tuple<variable_integration_info<T>...>& info, const settings& configuration){
+        static_assert((std::is_floating_point_v<T> && ...), "Monte Carlo integration requires floating point variables");
+        static_assert(sizeof...(T) <= Sequence::max_dimensions, "too many dimensions for the selected sequence");
+
+        const auto from = std::apply([](const auto& ...info_struct){
+            return std::array<double, sizeof...(T)>{static_cast<double>(std::min(info_struct.from, info_struct.to))...};
+        }, info);
+
+        const auto width = std::apply([](const auto& ...info_struct){
+            return std::array<double, sizeof...(T)>{std::fabs(static_cast<double>(info_struct.to) - static_cast<double>(info_struct.from))...};
+        }, info);
+
+        return [&function, from, width, seed = configuration.seed](std::uint64_t replicate, unsigned long int begin, unsigned long int end){
+            moments batch;
+            for (auto index = begin; index < end; index++){
+                batch.add([&]<size_t ...I>(std::index_sequence<I...>){
+                    return static_cast<double>(function(static_cast<T>(from[I] + width[I] * Sequence::sample(index, I, seed, replicate))...));
+                }(std::index_sequence_for<T...>()));
+            }
+            return batch;
+        };
+    }
+
+    // combines moments of every replicate into the final estimate
+    template <typename Sequence, typename ...T>
+    result make_result(const std::vector<moments>& replicates, unsigned long int samples_per_replicate, const std::tuple<variable_integration_info<T>...>& info){
+
+        const double volume = std::apply([](const auto& ...info_struct){
+            return (std::fabs(static_cast<double>(info_struct.to) - static_cast<double>(info_struct.from)) * ... * 1.0);
+        }, info);
+
+        const double n = samples_per_replicate;
+        const double r = replicates.size();
+
+        result output;
+        output.evaluations = samples_per_replicate * replicates.size();
+
+        if constexpr (Sequence::is_randomized){
+            std::tuple<double, double> sum = {0.0, 0.0};
+            std::tuple<double, double> sum_of_squares = {0.0, 0.0};
+
+            for (const auto& replicate : replicates){
+                const double estimate = replicate.total() / n * volume;
+                sum = mz::approx::internals::kahan_sum(sum, estimate);
+                sum_of_squares = mz::approx::internals::kahan_sum(sum_of_squares, estimate * estimate);
+            }
+
+            const double mean = (std::get<0>(sum) - std::get<1>(sum)) / r;
+            const double variance = std::max(0.0, (std::get<0>(sum_of_squares) - std::get<1>(sum_of_squares)) / r - mean * mean) * r / std::max(1.0, r - 1);
+
+            output.value = mean;
+            output.standard_error = std::sqrt(variance / r);
+        } else {
+            const auto& all = replicates.front();
+            const double mean = all.total() / n;
+            const double variance = std::max(0.0, all.total_of_squares() / n - mean * mean) * n / std::max(1.0, n - 1);
+
+            output.value = mean * volume;
+            output.standard_error = std::sqrt(variance / n) * volume;
+        }
+
+        return output;
+    }
+
+    // gives the number of replicates and samples per replicate, throws if the sequence cannot generate that many samples
+    template <typename Sequence>
+    constexpr std::tuple<unsigned long int, unsigned long int> split_samples(const settings& configuration){
+        const unsigned long int replicates = Sequence::is_randomized ? std::max(1ul, configuration.replicates) : 1ul;
+        const unsigned long int samples_per_replicate = std::max(1ul, configuration.samples / replicates);
+
+        if (samples_per_replicate > Sequence::max_samples)
+            throw std::runtime_error("too many samples per replicate for the selected sequence");
+
+        return {replicates, samples_per_replicate};
+    }
+
+    // used to approximate functions given by any callable with floating point parameters using samples of the selected sequence
+    template <typename Sequence = sequence::sobol, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::montecarlo::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        const auto [replicates, samples_per_replicate] = split_samples<Sequence>(configuration);
+        const auto sampler = make_sampler<Sequence>(function, info, configuration);
+
+        std::vector<moments> replicate_moments;
+        for (unsigned long int replicate = 0; replicate < replicates; replicate++)
+            replicate_moments.push_back(sampler(replicate, 0, samples_per_replicate));
+
+        return make_result<Sequence>(replicate_moments, samples_per_replicate, info);
+    }
+
+    // used to approximate functions given by any callable using multiple threads, samples are generated from their
+    // indices so the result does not depend on the number of threads
+    template <typename Sequence = sequence::sobol, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::montecarlo::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        const auto [replicates, samples_per_replicate] = split_samples<Sequence>(configuration);
+        const auto sampler = make_sampler<Sequence>(function, info, configuration);
+
+        std::vector<moments> replicate_moments;
+        for (unsigned long int replicate = 0; replicate < replicates; replicate++){
+            const auto batches = mz::approx::execution::map_chunks(policy, samples_per_replicate, [&](unsigned long int begin, unsigned long int end){
+                return sampler(replicate, begin, end);
+            });
+
+            // merge batches in a fixed order
+            moments merged;
+            for (const auto& batch : batches)
+                merged.merge(batch);
+            replicate_moments.push_back(merged);
+        }
+
+        return make_result<Sequence>(replicate_moments, samples_per_replicate, info);
+    }
+
+    template <typename Sequence = sequence::sobol, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::montecarlo::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate<Sequence>([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+    // used to approximate functions using multiple threads
+    template <typename Sequence = sequence::sobol, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::montecarlo::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate<Sequence>(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+}
+
+#endif
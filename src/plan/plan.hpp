@@ -0,0 +1,309 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_PLAN_HPP
+#define APPROX_PLAN_HPP
+
+#include <type_traits>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <array>
+#include <span>
+#include <tuple>
+
+namespace mz::approx::plan {
+
+    // grid of an integration method prepared once and executed against many integrands, coordinate and weight tables
+    // of every dimension are computed when the plan is built, the plan is immutable so it can be shared between threads
+    template <typename Arg, typename ...Args>
+    class grid_plan{
+    public:
+
+        // scale multiplies every output, it is used by methods with a constant weight such as the Riemann sums
+        constexpr explicit grid_plan(mz::approx::internals::grid_cursor<Arg, Args...> grid, double scale = 1.0): grid(std::move(grid)), scale(scale){}
+
+        constexpr unsigned long int size() const{
+            return grid.size();
+        }
+
+        constexpr const mz::approx::internals::grid_cursor<Arg, Args...>& cursor() const{
+            return grid;
+        }
+
+        // used to integrate any callable taking the variables of the plan, outputs are summed by the selected accumulator
+        template <typename Accumulator = mz::approx::accumulator::naive, typename F,
+                  std::enable_if_t<std::is_invocable_r_v<double, F&, const Arg&, const Args&...>, bool> = true>
+        constexpr double execute(F&& function) const{
+            return integrate_range<Accumulator>(function, 0, grid.size()).total();
+        }
+
+        // used to integrate any callable using multiple threads, chunks are summed by the accumulator and merged in a fixed order
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F,
+                  std::enable_if_t<std::is_invocable_r_v<double, F&, const Arg&, const Args&...>, bool> = true>
+        double execute(const mz::approx::execution::parallel_policy& policy, F&& function) const{
+            return mz::approx::execution::reduce_chunks(policy, grid.size(), [&](unsigned long int begin, unsigned long int end){
+                return integrate_range<Accumulator>(function, begin, end).partial();
+            });
+        }
+
+        // used to integrate a batch integrand taking a block of first dimension coordinates as a span, the remaining
+        // coordinates as scalars and writing a block of outputs
+        template <typename Accumulator = mz::approx::accumulator::lanes<>, typename F, std::enable_if_t<std::conjunction_v<std::negation<std::is_invocable<F&, const Arg&, const Args&...>>,
+                                                                std::disjunction<std::is_invocable<F&, std::span<const Arg>, const Args&..., std::span<double>>,
+                                                                                 std::is_invocable<F&, std::span<const Arg>, const Args&..., std::span<float>>>>, bool> = true>
+        constexpr double execute(F&& function) const{
+            const auto [result, compensation] = integrate_batches<Accumulator>(function, 0, grid.size());
+            return result - compensation;
+        }
+
+        // used to integrate a batch integrand using multiple threads
+        template <typename Accumulator = mz::approx::accumulator::lanes<>, typename F, std::enable_if_t<std::conjunction_v<std::negation<std::is_invocable<F&, const Arg&, const Args&...>>,
+                                                                std::disjunction<std::is_invocable<F&, std::span<const Arg>, const Args&..., std::span<double>>,
+                                                                                 std::is_invocable<F&, std::span<const Arg>, const Args&..., std::span<float>>>>, bool> = true>
+        double execute(const mz::approx::execution::parallel_policy& policy, F&& function) const{
+            return mz::approx::execution::reduce_chunks(policy, grid.size(), [&](unsigned long int begin, unsigned long int end){
+                return integrate_batches<Accumulator>(function, begin, end);
+            });
+        }
+
+        // used to integrate vector valued callables returning std::array, all components are accumulated in a single sweep,
+        // each of them by its own accumulator
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F, std::enable_if_t<mz::approx::internals::component_array<std::invoke_result_t<F&, const Arg&, const Args&...>>::value, bool> = true>
+        constexpr auto execute(F&& function) const{
+            std::array<double, std::tuple_size_v<std::invoke_result_t<F&, const Arg&, const Args&...>>> results;
+            sum_components<Accumulator>(array_evaluator(function), results);
+            return results;
+        }
+
+        // used to integrate vector valued callables using multiple threads
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F, std::enable_if_t<mz::approx::internals::component_array<std::invoke_result_t<F&, const Arg&, const Args&...>>::value, bool> = true>
+        auto execute(const mz::approx::execution::parallel_policy& policy, F&& function) const{
+            std::array<double, std::tuple_size_v<std::invoke_result_t<F&, const Arg&, const Args&...>>> results;
+            sum_components<Accumulator>(policy, array_evaluator(function), results);
+            return results;
+        }
+
+        // used to integrate callables writing their outputs into a span, one output per entry of results
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F, std::enable_if_t<std::is_invocable_v<F&, const Arg&, const Args&..., std::span<double>>, bool> = true>
+        constexpr void execute(F&& function, std::span<double> results) const{
+            sum_components<Accumulator>(span_evaluator(function), results);
+        }
+
+        // used to integrate callables writing their outputs into a span using multiple threads
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F, std::enable_if_t<std::is_invocable_v<F&, const Arg&, const Args&..., std::span<double>>, bool> = true>
+        void execute(const mz::approx::execution::parallel_policy& policy, F&& function, std::span<double> results) const{
+            sum_components<Accumulator>(policy, span_evaluator(function), results);
+        }
+
+        // used to integrate a sum of per dimension functions, every term is integrated along its own dimension and
+        // multiplied by the measure of the remaining ones so only the sum of the extents is evaluated, axes and terms are
+        // summed by the accumulator
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename ...F>
+        constexpr double execute(const mz::approx::separable::sum<F...>& function) const{
+            static_assert(sizeof...(F) == 1 + sizeof...(Args), "separable sum needs one term per dimension");
+
+            const auto integrals = axis_integrals<Accumulator>(function.functions);
+            const auto measures = axis_integrals<Accumulator>(std::tuple{[](const Arg&){ return 1.0; }, [](const Args&){ return 1.0; }...});
+
+            Accumulator result;
+            for (std::size_t term = 0; term < integrals.size(); term++){
+                double value = integrals[term];
+                for (std::size_t dimension = 0; dimension < measures.size(); dimension++)
+                    value *= dimension == term ? 1.0 : measures[dimension];
+
+                result.add(value);
+            }
+
+            return result.total() * scale;
+        }
+
+        // used to integrate a product of per dimension functions, the integral is a product of one dimensional integrals
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename ...F>
+        constexpr double execute(const mz::approx::separable::product<F...>& function) const{
+            static_assert(sizeof...(F) == 1 + sizeof...(Args), "separable product needs one factor per dimension");
+
+            const auto integrals = axis_integrals<Accumulator>(function.functions);
+            return std::accumulate(integrals.begin(), integrals.end(), 1.0, std::multiplies<>()) * scale;
+        }
+
+        // used to integrate a curried function, each stage is called once per coordinate of its dimension
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F>
+        constexpr double execute(const mz::approx::separable::curried<F>& function) const{
+            static_assert(std::tuple_size_v<typename mz::approx::separable::curried_arguments<F>::type> == 1 + sizeof...(Args),
+                          "curried function needs one stage per dimension");
+
+            return integrate_stage<0, Accumulator>(function.function, 0, grid.template axis<0>().size()).total() * scale;
+        }
+
+        // separable functions need only the sum of the extents evaluations so they are integrated on the calling thread
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename ...F>
+        double execute(const mz::approx::execution::parallel_policy&, const mz::approx::separable::sum<F...>& function) const{
+            return execute<Accumulator>(function);
+        }
+
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename ...F>
+        double execute(const mz::approx::execution::parallel_policy&, const mz::approx::separable::product<F...>& function) const{
+            return execute<Accumulator>(function);
+        }
+
+        // used to integrate a curried function using multiple threads, coordinates of the first dimension are split into chunks
+        template <typename Accumulator = mz::approx::accumulator::kahan, typename F>
+        double execute(const mz::approx::execution::parallel_policy& policy, const mz::approx::separable::curried<F>& function) const{
+            static_assert(std::tuple_size_v<typename mz::approx::separable::curried_arguments<F>::type> == 1 + sizeof...(Args),
+                          "curried function needs one stage per dimension");
+
+            return mz::approx::execution::reduce_chunks(policy, grid.template axis<0>().size(), [&](unsigned long int begin, unsigned long int end){
+                const auto [result, compensation] = integrate_stage<0, Accumulator>(function.function, begin, end).partial();
+                return std::tuple<double, double>{result * scale, compensation * scale};
+            });
+        }
+
+    private:
+
+        // weighted one dimensional integral of every function along its own dimension
+        template <typename Accumulator, typename Functions>
+        constexpr std::array<double, 1 + sizeof...(Args)> axis_integrals(const Functions& functions) const{
+            return [&]<size_t ...I>(std::index_sequence<I...>){
+                return std::array<double, 1 + sizeof...(Args)>{axis_integral<I, Accumulator>(std::get<I>(functions))...};
+            }(std::index_sequence_for<Arg, Args...>());
+        }
+
+        template <std::size_t Dimension, typename Accumulator, typename F>
+        constexpr double axis_integral(const F& function) const{
+            return integrate_stage<Dimension, Accumulator>(function, 0, grid.template axis<Dimension>().size()).total();
+        }
+
+        // sums a stage over the coordinates [begin, end) of its dimension, stages returning callables are integrated
+        // further along the next dimension
+        template <std::size_t Dimension, typename Accumulator, typename F>
+        constexpr Accumulator integrate_stage(const F& function, unsigned long int begin, unsigned long int end) const{
+            const auto axis = grid.template axis<Dimension>();
+
+            Accumulator result;
+            for (auto index = begin; index < end; index++){
+                const auto output = function(axis[index]);
+
+                double value;
+                if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(output)>>)
+                    value = static_cast<double>(output);
+                else{
+                    static_assert(Dimension < sizeof...(Args), "curried function has more stages than the plan has dimensions");
+                    value = integrate_stage<Dimension + 1, Accumulator>(output, 0, grid.template axis<Dimension + 1>().size()).total();
+                }
+
+                result.add(value * grid.axis_weight(Dimension, index));
+            }
+
+            return result;
+        }
+
+        template <typename F>
+        static constexpr auto array_evaluator(F& function){
+            return [&function](std::span<double> outputs, const auto& ...coordinates){
+                const auto values = function(coordinates...);
+                std::copy(values.begin(), values.end(), outputs.begin());
+            };
+        }
+
+        template <typename F>
+        static constexpr auto span_evaluator(F& function){
+            return [&function](std::span<double> outputs, const auto& ...coordinates){
+                function(coordinates..., outputs);
+            };
+        }
+
+        // every output of a point is added to its own accumulator, evaluate(outputs, coordinates...) writes the outputs
+        // of a single point
+        template <typename Accumulator, typename Evaluate>
+        constexpr std::vector<Accumulator> integrate_components(const Evaluate& evaluate, std::size_t components,
+                                                                unsigned long int begin, unsigned long int end) const{
+
+            std::vector<Accumulator> sums(components);
+            std::vector<double> outputs(components);
+
+            const auto add_outputs = [&](double weight){
+                for (std::size_t component = 0; component < components; component++)
+                    sums[component].add(outputs[component] * weight);
+            };
+
+            if (grid.is_weighted())
+                grid.for_each_weighted(begin, end, [&](double weight, const auto& ...coordinates){
+                    evaluate(std::span<double>(outputs), coordinates...);
+                    add_outputs(weight);
+                });
+            else
+                grid.for_each(begin, end, [&](const auto& ...coordinates){
+                    evaluate(std::span<double>(outputs), coordinates...);
+                    add_outputs(scale);
+                });
+
+            return sums;
+        }
+
+        template <typename Accumulator, typename Evaluate>
+        constexpr void sum_components(const Evaluate& evaluate, std::span<double> results) const{
+            const auto sums = integrate_components<Accumulator>(evaluate, results.size(), 0, grid.size());
+
+            for (std::size_t component = 0; component < results.size(); component++)
+                results[component] = sums[component].total();
+        }
+
+        // per chunk sums are merged component by component in the chunk order
+        template <typename Accumulator, typename Evaluate>
+        void sum_components(const mz::approx::execution::parallel_policy& policy, const Evaluate& evaluate, std::span<double> results) const{
+            const auto partial_sums = mz::approx::execution::map_chunks(policy, grid.size(), [&](unsigned long int begin, unsigned long int end){
+                return integrate_components<Accumulator>(evaluate, results.size(), begin, end);
+            });
+
+            std::vector<std::tuple<double, double>> sums(results.size(), {0.0, 0.0});
+            for (const auto& partial : partial_sums)
+                for (std::size_t component = 0; component < results.size(); component++){
+                    const auto [sum, compensation] = partial[component].partial();
+                    sums[component] = mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(sums[component], sum), -compensation);
+                }
+
+            for (std::size_t component = 0; component < results.size(); component++)
+                results[component] = std::get<0>(sums[component]) - std::get<1>(sums[component]);
+        }
+
+        template <typename Accumulator, typename F>
+        constexpr Accumulator integrate_range(F& function, unsigned long int begin, unsigned long int end) const{
+            Accumulator result;
+
+            if (grid.is_weighted())
+                grid.for_each_weighted(begin, end, [&](double weight, const auto& ...coordinates){
+                    result.add(function(coordinates...) * weight);
+                });
+            else
+                grid.for_each(begin, end, [&](const auto& ...coordinates){
+                    result.add(function(coordinates...) * scale);
+                });
+
+            return result;
+        }
+
+        // weights of the cursor are applied to the outputs of every batch, the constant scale is applied to the sum
+        template <typename Accumulator, typename F>
+        constexpr std::tuple<double, double> integrate_batches(F& function, unsigned long int begin, unsigned long int end) const{
+            Accumulator result;
+
+            mz::approx::internals::for_each_batch(grid, begin, end, function, [&](const auto outputs, std::span<const double> weights, double outer_weight){
+                mz::approx::accumulator::add_block(result, outputs, weights, outer_weight);
+            });
+
+            const auto [sum, compensation] = result.partial();
+            return grid.is_weighted() ? std::tuple<double, double>{sum, compensation} : std::tuple<double, double>{sum * scale, compensation * scale};
+        }
+
+        const mz::approx::internals::grid_cursor<Arg, Args...> grid;
+        const double scale;
+    };
+
+}
+
+#endif
@@ -6,6 +6,8 @@
 #ifndef APPROX_RIEMANN_HPP
 #define APPROX_RIEMANN_HPP
 
+#include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <span>
 
@@ -13,10 +15,10 @@ namespace mz::approx::riemann {
 
     namespace method {
 
-        struct left_point: public mz::approx::internals::equal_greather_than {
+        struct left_point{
 
             template <typename T>
-            static constexpr T init(const T& from, const T& step_size){
+            static constexpr T init(const T& from, const T&){
                 return from;
             }
 
@@ -38,7 +40,7 @@ namespace mz::approx::riemann {
 
         };
 
-        struct mid_point: public mz::approx::internals::greather_than{
+        struct mid_point{
 
             template <typename T>
             static constexpr T init(const T& from, const T& step_size){
@@ -64,7 +66,7 @@ namespace mz::approx::riemann {
 
         };
 
-        struct right_point: public mz::approx::internals::greather_than{
+        struct right_point{
 
             template <typename T>
             static constexpr T init(const T& from, const T& step_size){
@@ -97,93 +99,445 @@ namespace mz::approx::riemann {
         const unsigned long int steps = 0;
     };
 
-    template <typename Method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
-    constexpr double approximate(const std::function<double(Arg, Args...)>& function,
-                                 const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info){
+    // used to approximate functions given by any callable with arithmetic parameters, the callable is invoked directly
+    // with the coordinates of each point so cheap integrands can be inlined into the loop, outputs are summed by the
+    // selected accumulator
+    template <typename Method, typename Accumulator = mz::approx::accumulator::naive, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_integrand, bool> = true>
+    constexpr double approximate(F&& function, const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
 
-        constexpr auto calculate_total_number_of_points = [](auto&& ...info_struct) {
-            return (info_struct.steps * ...);
+        constexpr auto calculate_delta = [](auto&& ...dimension_data){
+            return (static_cast<double>(dimension_data.step_size) * ...);
         };
 
-        constexpr auto initialize_dimension_data = []<typename T>(auto&& dimension_data, const mz::approx::riemann::variable_integration_info<T>& info_struct){
-            auto& [current_coordinate, starting_position, stop_at, step_size, compensation] = dimension_data;
-            auto [from, to, steps] = info_struct;
+        // pick each entry from info tuple and use it to initialize dimension data of a corresponding variable
+        const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+        const mz::approx::internals::grid_cursor grid(point_data);
+
+        // calculate n-dimensional delta
+        const double delta = std::apply(calculate_delta, point_data);
+
+        Accumulator result;
+        grid.for_each(0, grid.size(), [&](const auto& ...coordinates){
+
+            // evaluate the function and add slice area to the result
+            result.add(function(coordinates...) * delta);
+        });
 
-            // check whenever we have to swap integration range
-            if (from > to)
-                std::swap(from, to);
+        return result.total();
+    }
+
+    // used to approximate functions given by any callable using multiple threads, each chunk of the grid is summed by the
+    // accumulator and the partial sums are merged in a fixed order, results are reproducible regardless of the number of threads
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_integrand, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
 
-            stop_at = to;
-            step_size = (to - from) / steps;
-            current_coordinate = starting_position = Method::init(from, step_size);
-            return dimension_data;
+        constexpr auto calculate_delta = [](auto&& ...dimension_data){
+            return (static_cast<double>(dimension_data.step_size) * ...);
         };
 
+        // pick each entry from info tuple and use it to initialize dimension data of a corresponding variable
+        const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+        const mz::approx::internals::grid_cursor grid(point_data);
+
+        // calculate n-dimensional delta
+        const double delta = std::apply(calculate_delta, point_data);
+
+        const auto integrate_range = [&](unsigned long int begin, unsigned long int end){
+            Accumulator result;
+
+            // the cursor jumps directly to the first point of the chunk
+            grid.for_each(begin, end, [&](const auto& ...coordinates){
+                result.add(function(coordinates...) * delta);
+            });
+
+            return result.partial();
+        };
+
+        return mz::approx::execution::reduce_chunks(policy, grid.size(), integrate_range);
+    }
+
+    // used to approximate functions given by a batch integrand, it receives blocks of first dimension coordinates as spans
+    // together with the remaining coordinates as scalars and writes a block of double or float outputs at once which are
+    // then reduced by the accumulator, by default using a vectorized compensated sum
+    template <typename Method, typename Accumulator = mz::approx::accumulator::lanes<>, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_batch_integrand, bool> = true>
+    constexpr double approximate(F&& function, const typename Traits::template batch_tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
         constexpr auto calculate_delta = [](auto&& ...dimension_data){
             return (static_cast<double>(dimension_data.step_size) * ...);
         };
 
-        const unsigned long int total_number_of_points = std::apply(calculate_total_number_of_points , info);
-        using point_data_type = mz::approx::internals::make_tuple_of<mz::approx::internals::dimension_data, Arg, Args...>;
+        // pick each entry from info tuple and use it to initialize dimension data of a corresponding variable
+        const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+        const mz::approx::internals::grid_cursor grid(point_data);
+
+        // calculate n-dimensional delta
+        const double delta = std::apply(calculate_delta, point_data);
+
+        Accumulator result;
+        mz::approx::internals::for_each_batch(grid, 0, grid.size(), function, [&](const auto outputs, std::span<const double> weights, double outer_weight){
+            mz::approx::accumulator::add_block(result, outputs, weights, outer_weight);
+        });
+
+        return result.total() * delta;
+    }
+
+    // used to approximate functions given by a batch integrand using multiple threads
+    template <typename Method, typename Accumulator = mz::approx::accumulator::lanes<>, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_batch_integrand, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template batch_tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
+        constexpr auto calculate_delta = [](auto&& ...dimension_data){
+            return (static_cast<double>(dimension_data.step_size) * ...);
+        };
 
-        // pick each entry from info tuple and input them into the initialize_dimension_data function together with a default constructed dimension_data struct
-        point_data_type point_data = [&]<size_t... Is>(std::index_sequence<Is...>){
-            return std::make_tuple(initialize_dimension_data(typename std::tuple_element<Is, point_data_type>::type(), std::get<Is>(info))... );
-        }(std::make_index_sequence<std::tuple_size_v<point_data_type>>());
+        // pick each entry from info tuple and use it to initialize dimension data of a corresponding variable
+        const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+        const mz::approx::internals::grid_cursor grid(point_data);
 
         // calculate n-dimensional delta
         const double delta = std::apply(calculate_delta, point_data);
 
-        double result = 0;
-        for (unsigned long int current_point = 0; current_point < total_number_of_points; current_point++){
+        const auto integrate_range = [&](unsigned long int begin, unsigned long int end){
+            Accumulator result;
+            mz::approx::internals::for_each_batch(grid, begin, end, function, [&](const auto outputs, std::span<const double> weights, double outer_weight){
+                mz::approx::accumulator::add_block(result, outputs, weights, outer_weight);
+            });
 
-            // bind point coordinates to the given function and evaluate it
-            const auto output = std::apply(mz::approx::internals::bind_function_parameters<decltype(function), Arg, Args...>{function}, point_data)();
+            const auto [sum, compensation] = result.partial();
+            return std::tuple<double, double>{sum * delta, compensation * delta};
+        };
 
-            // add slice area to the result
-            result += output * delta;
+        return mz::approx::execution::reduce_chunks(policy, grid.size(), integrate_range);
+    }
 
-            // advance point coordinates
-            std::apply(mz::approx::internals::advance_to_next_point<Method, Arg, Args...>, point_data);
-        }
+    // used to prepare the grid of a Riemann sum once so it can be executed against many integrands
+    template <typename Method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    constexpr mz::approx::plan::grid_plan<Arg, Args...> make_plan(const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info){
 
-        return result;
+        constexpr auto calculate_delta = [](auto&& ...dimension_data){
+            return (static_cast<double>(dimension_data.step_size) * ...);
+        };
+
+        const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+        return mz::approx::plan::grid_plan<Arg, Args...>(mz::approx::internals::grid_cursor<Arg, Args...>(point_data), std::apply(calculate_delta, point_data));
+    }
+
+    // used to approximate separable functions given as a separable::sum or separable::product of per dimension functions,
+    // which need only the sum of the steps evaluations, or as a separable::curried chain of per dimension stages
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool> = true>
+    constexpr double approximate(const Separable& function, const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Method, T...>(info_tuple).template execute<Accumulator>(function);
+        }(info);
+    }
+
+    // used to approximate separable functions using multiple threads
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const Separable& function,
+                       const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Method, T...>(info_tuple).template execute<Accumulator>(policy, function);
+        }(info);
+    }
+
+    // used to approximate vector valued functions returning std::array, all components are integrated in a single sweep
+    // over the grid and each of them is accumulated using its own Kahan sum
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_vector_integrand, bool> = true>
+    constexpr auto approximate(F&& function, const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Method, T...>(info_tuple).template execute<Accumulator>(function);
+        }(info);
+    }
+
+    // used to approximate vector valued functions returning std::array using multiple threads
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_vector_integrand, bool> = true>
+    auto approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                     const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<Method, T...>(info_tuple).template execute<Accumulator>(policy, function);
+        }(info);
+    }
+
+    // used to approximate functions writing several outputs into a span, results has to hold one entry per output
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_span_integrand, bool> = true>
+    constexpr void approximate(F&& function, const typename Traits::template span_tuple_of<mz::approx::riemann::variable_integration_info>& info, std::span<double> results){
+
+        [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            make_plan<Method, T...>(info_tuple).template execute<Accumulator>(function, results);
+        }(info);
+    }
+
+    // used to approximate functions writing several outputs into a span using multiple threads
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_span_integrand, bool> = true>
+    void approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                     const typename Traits::template span_tuple_of<mz::approx::riemann::variable_integration_info>& info, std::span<double> results){
+
+        [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            make_plan<Method, T...>(info_tuple).template execute<Accumulator>(policy, function, results);
+        }(info);
+    }
+
+    template <typename Method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    double approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info){
+
+        return approximate<Method>([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
+    }
+
+    // used to approximate functions using multiple threads
+    template <typename Method, typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info){
+
+        return approximate<Method>(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
+    }
+
+    // area between two consecutive samples, pairs which are not sorted in an ascending order do not contribute
+    template <typename Method, typename Output, typename Input>
+    constexpr Output sample_area(const std::tuple<std::tuple<Input>, Output>& centre, const std::tuple<std::tuple<Input>, Output>& right){
+        return mz::approx::internals::points_are_adjacent(centre, right) ? Method::estimate_area(centre, right) : 0;
     }
 
     template <typename method, typename Input, typename Output, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Input, Output>(), bool> = true>
     constexpr double approximate(const std::vector<std::tuple<std::tuple<Input>, Output>>& points){
 
-        using point_type = std::tuple<std::tuple<Input>, Output>;
+        // the last point has no right neighbour so it only closes the last interval
+        Output result = 0;
+        for (std::size_t index = 0; index + 1 < points.size(); index++)
+            result += sample_area<method>(points[index], points[index + 1]);
+
+        return result;
+    }
+
+    // used to approximate the area under a curve given by separate ranges of inputs and outputs, samples are read
+    // in place and only a pair of neighbouring points is kept at a time
+    template <typename Method, typename InputIterator, typename OutputIterator,
+              std::enable_if_t<std::forward_iterator<InputIterator> && std::forward_iterator<OutputIterator>, bool> = true>
+    constexpr double approximate(InputIterator inputs_begin, InputIterator inputs_end, OutputIterator outputs_begin){
+
+        using point_type = std::tuple<std::tuple<std::iter_value_t<InputIterator>>, std::iter_value_t<OutputIterator>>;
+        static_assert(mz::approx::internals::all_types_are_arithmetic<std::iter_value_t<InputIterator>, std::iter_value_t<OutputIterator>>(),
+                      "samples have to be arithmetic");
+
+        if (inputs_begin == inputs_end)
+            return 0;
+
+        point_type centre = {{*inputs_begin}, *outputs_begin};
+
+        // areas are summed in double using Kahan summation like the parallel overload does, whatever the type of the outputs
+        std::tuple<double, double> result = {0.0, 0.0};
+        for (++inputs_begin, ++outputs_begin; inputs_begin != inputs_end; ++inputs_begin, ++outputs_begin){
+            const point_type right = {{*inputs_begin}, *outputs_begin};
+            result = mz::approx::internals::kahan_sum(result, sample_area<Method>(centre, right));
+            centre = right;
+        }
+
+        return std::get<0>(result) - std::get<1>(result);
+    }
+
+    // used to approximate the area under a curve given by spans of inputs and outputs, pairs beyond the shorter span are ignored
+    template <typename Method, typename Input, typename Output,
+              std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Input>, std::remove_const_t<Output>>(), bool> = true>
+    constexpr double approximate(std::span<Input> inputs, std::span<Output> outputs){
+
+        const auto size = std::min(inputs.size(), outputs.size());
+        return approximate<Method>(inputs.begin(), std::next(inputs.begin(), size), outputs.begin());
+    }
+
+    // used to approximate the area under a curve given by spans of inputs and outputs using multiple threads, intervals
+    // between samples are split into chunks which are summed using Kahan summation and merged in a fixed order
+    template <typename Method, typename Input, typename Output,
+              std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Input>, std::remove_const_t<Output>>(), bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, std::span<Input> inputs, std::span<Output> outputs){
 
-        // create a local copy of the points
-        std::vector<point_type> local_data;
-        local_data.reserve(points.size() + 2);
+        using point_type = std::tuple<std::tuple<std::remove_const_t<Input>>, std::remove_const_t<Output>>;
 
-        // append copy of the first and the last element to ensure coherence of the algorithm
-        local_data.insert(local_data.end(), points.begin(), points.end());
-        local_data.push_back(points.back());
+        const auto size = std::min(inputs.size(), outputs.size());
+        if (size < 2)
+            return 0;
 
-        // create vector views to avoid any further unnecessary copying
-        auto equal_range = std::span(local_data.begin(), std::prev(local_data.end()));
-        auto front_iter = std::next(local_data.begin(), 1);
+        const auto integrate_range = [&](unsigned long int begin, unsigned long int end){
+            std::tuple<double, double> result = {0.0, 0.0};
 
-        const auto estimate_area = [&front_iter](const auto& result, const auto& val){
+            for (auto index = begin; index < end; index++)
+                result = mz::approx::internals::kahan_sum(result, sample_area<Method>(point_type{{inputs[index]}, outputs[index]},
+                                                                                      point_type{{inputs[index + 1]}, outputs[index + 1]}));
 
-            // if points are adjacent estimate area under the curve connecting them
-            const auto output = mz::approx::internals::points_are_adjacent(val, *front_iter)
-                    ? method::estimate_area(val, *front_iter) : 0;
+            return result;
+        };
+
+        return mz::approx::execution::reduce_chunks(policy, size - 1, integrate_range);
+    }
 
-            // advance secondary iterators
-            front_iter++;
+    // weights of the samples along a single axis, each sample gets its share of the areas estimated by the method
+    // for both of its neighbouring intervals
+    template <typename Method, typename Input>
+    std::vector<double> axis_weights(std::span<Input> axis){
 
-            // add output to the current result
-            return result + output;
+        using point_type = std::tuple<std::tuple<std::remove_const_t<Input>>, double>;
+
+        std::vector<double> weights(axis.size(), 0.0);
+        for (std::size_t index = 0; index + 1 < axis.size(); index++){
+            weights[index] += sample_area<Method>(point_type{{axis[index]}, 1.0}, point_type{{axis[index + 1]}, 0.0});
+            weights[index + 1] += sample_area<Method>(point_type{{axis[index]}, 0.0}, point_type{{axis[index + 1]}, 1.0});
+        }
+
+        return weights;
+    }
+
+    // sums the gridded samples in [begin, end) multiplied by the products of their axis weights, the first axis varies the fastest
+    template <typename Output, std::size_t Dimensions>
+    std::tuple<double, double> weighted_sample_sum(std::span<Output> outputs, const std::array<std::vector<double>, Dimensions>& weights,
+                                                   unsigned long int begin, unsigned long int end){
+
+        std::array<std::size_t, Dimensions> position;
+        for (std::size_t dimension = 0, rest = begin; dimension < Dimensions; dimension++){
+            position[dimension] = rest % weights[dimension].size();
+            rest /= weights[dimension].size();
+        }
+
+        // product of the weights of all axes but the first one only changes between rows
+        double outer_weight = 1;
+        const auto update_outer_weight = [&](){
+            outer_weight = 1;
+            for (std::size_t dimension = 1; dimension < Dimensions; dimension++)
+                outer_weight *= weights[dimension][position[dimension]];
         };
+        update_outer_weight();
+
+        std::tuple<double, double> result = {0.0, 0.0};
+        for (auto index = begin; index < end; index++){
+            result = mz::approx::internals::kahan_sum(result, outputs[index] * weights[0][position[0]] * outer_weight);
+
+            if (++position[0] < weights[0].size())
+                continue;
+
+            position[0] = 0;
+            for (std::size_t dimension = 1; dimension < Dimensions; dimension++){
+                if (++position[dimension] < weights[dimension].size())
+                    break;
+                position[dimension] = 0;
+            }
+            update_outer_weight();
+        }
 
-        // calculate and return results
-        return std::accumulate(equal_range.begin(), equal_range.end(), Output(0), estimate_area);
+        return result;
     }
 
+    // used to approximate the volume under gridded samples, axes hold sorted coordinates of every dimension and outputs
+    // hold the samples of the whole tensor grid with the first axis varying the fastest, the method is applied along
+    // every axis so only the axis weights are allocated
+    template <typename Method, typename Output, typename ...Inputs,
+              std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Output>, std::remove_const_t<Inputs>...>(), bool> = true>
+    double approximate(const std::tuple<std::span<Inputs>...>& axes, std::span<Output> outputs){
+
+        const auto weights = std::apply([](const auto& ...axis){
+            return std::array<std::vector<double>, sizeof...(Inputs)>{axis_weights<Method>(axis)...};
+        }, axes);
+
+        const auto size = std::min<unsigned long int>(outputs.size(), std::apply([](const auto& ...axis){ return (axis.size() * ...); }, axes));
+        if (size == 0)
+            return 0;
+
+        const auto [result, compensation] = weighted_sample_sum(outputs, weights, 0, size);
+        return result - compensation;
+    }
+
+    // used to approximate the volume under gridded samples using multiple threads
+    template <typename Method, typename Output, typename ...Inputs,
+              std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<std::remove_const_t<Output>, std::remove_const_t<Inputs>...>(), bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const std::tuple<std::span<Inputs>...>& axes, std::span<Output> outputs){
+
+        const auto weights = std::apply([](const auto& ...axis){
+            return std::array<std::vector<double>, sizeof...(Inputs)>{axis_weights<Method>(axis)...};
+        }, axes);
+
+        const auto size = std::min<unsigned long int>(outputs.size(), std::apply([](const auto& ...axis){ return (axis.size() * ...); }, axes));
+
+        return mz::approx::execution::reduce_chunks(policy, size, [&](unsigned long int begin, unsigned long int end){
+            return weighted_sample_sum(outputs, weights, begin, end);
+        });
+    }
+
+    // used to integrate samples arriving over time, only the first and the previous point are kept together with
+    // a compensated sum, accumulators of adjacent ranges can be merged into one which covers both of them, every
+    // interval is added exactly once either way but the compensated sums are grouped differently so a merged result
+    // may differ from a single stream over the same samples in the last bit
+    template <typename Method, typename Input, typename Output>
+    class stream_accumulator{
+    public:
+        static_assert(mz::approx::internals::all_types_are_arithmetic<Input, Output>(), "samples have to be arithmetic");
+
+        using point_type = std::tuple<std::tuple<Input>, Output>;
+
+        constexpr void push(const point_type& point){
+            if (count++ == 0)
+                first = point;
+            else
+                sum = mz::approx::internals::kahan_sum(sum, static_cast<double>(sample_area<Method>(last, point)));
+
+            last = point;
+        }
+
+        constexpr void push(const Input& input, const Output& output){
+            push(point_type{{input}, output});
+        }
+
+        // pushes a batch of samples, pairs beyond the shorter span are ignored
+        constexpr void push(std::span<const Input> inputs, std::span<const Output> outputs){
+            const auto size = std::min(inputs.size(), outputs.size());
+            for (std::size_t index = 0; index < size; index++)
+                push(inputs[index], outputs[index]);
+        }
+
+        // appends samples of a range which follows the range of this accumulator, the interval between
+        // the last point of this one and the first point of the other one is added as well
+        constexpr stream_accumulator& merge(const stream_accumulator& later){
+            if (later.count == 0)
+                return *this;
+
+            if (count == 0)
+                return *this = later;
+
+            sum = mz::approx::internals::kahan_sum(sum, static_cast<double>(sample_area<Method>(last, later.first)));
+
+            const auto& [later_sum, later_compensation] = later.sum;
+            sum = mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(sum, later_sum), -later_compensation);
+
+            last = later.last;
+            count += later.count;
+            return *this;
+        }
+
+        // integral over all samples pushed so far
+        constexpr double result() const{
+            return std::get<0>(sum) - std::get<1>(sum);
+        }
+
+        constexpr unsigned long int size() const{
+            return count;
+        }
+
+    private:
+        point_type first{};
+        point_type last{};
+        std::tuple<double, double> sum = {0.0, 0.0};
+        unsigned long int count = 0;
+    };
+
 }
 
 #endif
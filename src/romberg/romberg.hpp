@@ -0,0 +1,236 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_ROMBERG_HPP
+#define APPROX_ROMBERG_HPP
+
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <cmath>
+
+namespace mz::approx::romberg {
+
+    // steps is the number of trapezoid intervals of the first level, every next level doubles it
+    template <typename Type>
+    struct variable_integration_info{
+        Type from = 0;
+        Type to = 0;
+        const unsigned long int steps = 1;
+    };
+
+    // refinement stops once the diagonal entries of two consecutive levels of the Romberg table differ by less than
+    // max(absolute, relative * |value|) or when the next level would exceed the evaluation budget
+    struct settings{
+        unsigned int max_level = 20;
+        double absolute = 1e-10;
+        double relative = 1e-10;
+        unsigned long int max_evaluations = 10'000'000;
+    };
+
+    struct result{
+        double value = 0;
+        double error = 0;
+        unsigned long int evaluations = 0;
+        unsigned int level = 0;
+    };
+
+    template <std::size_t Dimensions>
+    struct level_grid{
+        std::array<double, Dimensions> from{};
+        std::array<double, Dimensions> width{};
+        std::array<unsigned long int, Dimensions> intervals{};
+
+        // number of nodes of the level, every dimension spans both ends of its range
+        unsigned long int size() const{
+            unsigned long int nodes = 1;
+            for (const auto count : intervals)
+                nodes *= count + 1;
+            return nodes;
+        }
+
+        // product of the step sizes of all dimensions
+        double cell_volume() const{
+            double volume = 1;
+            for (std::size_t dimension = 0; dimension < Dimensions; dimension++)
+                volume *= width[dimension] / intervals[dimension];
+            return volume;
+        }
+    };
+
+    // sums outputs of the nodes in [begin, end) of the level grid multiplied by their end point factors, nodes with
+    // only even indices were already evaluated by the previous level and are skipped unless it is the first level
+    template <typename ...T, typename F>
+    std::tuple<double, double> sum_new_nodes(F& function, const level_grid<sizeof...(T)>& grid, bool first_level,
+                                             unsigned long int begin, unsigned long int end){
+
+        constexpr auto dimensions = sizeof...(T);
+
+        // decode the first node of the range, the first dimension varies the fastest
+        std::array<unsigned long int, dimensions> position;
+        for (std::size_t dimension = 0, rest = begin; dimension < dimensions; dimension++){
+            position[dimension] = rest % (grid.intervals[dimension] + 1);
+            rest /= grid.intervals[dimension] + 1;
+        }
+
+        // end point factors and parity of all dimensions but the first one only change between rows
+        double tail_factor = 1;
+        bool tail_is_even = true;
+        const auto update_tail = [&](){
+            tail_factor = 1;
+            tail_is_even = true;
+            for (std::size_t dimension = 1; dimension < dimensions; dimension++){
+                if (position[dimension] == 0 || position[dimension] == grid.intervals[dimension])
+                    tail_factor /= 2;
+                tail_is_even = tail_is_even && position[dimension] % 2 == 0;
+            }
+        };
+        update_tail();
+
+        std::tuple<double, double> result = {0.0, 0.0};
+        for (auto index = begin; index < end; index++){
+
+            if (first_level || !tail_is_even || position[0] % 2){
+                const auto output = [&]<size_t ...I>(std::index_sequence<I...>){
+                    return static_cast<double>(function(static_cast<T>(grid.from[I] + grid.width[I] * position[I] / grid.intervals[I])...));
+                }(std::index_sequence_for<T...>());
+
+                const double factor = (position[0] == 0 || position[0] == grid.intervals[0]) ? tail_factor / 2 : tail_factor;
+                result = mz::approx::internals::kahan_sum(result, output * factor);
+            }
+
+            // advance to the next node, tail data is refreshed only when a row is finished
+            if (++position[0] <= grid.intervals[0])
+                continue;
+
+            position[0] = 0;
+            for (std::size_t dimension = 1; dimension < dimensions; dimension++){
+                if (++position[dimension] <= grid.intervals[dimension])
+                    break;
+                position[dimension] = 0;
+            }
+            update_tail();
+        }
+
+        return result;
+    }
+
+    // refines the tensor trapezoidal rule level by level, sums of the end point weighted outputs are carried forward
+    // so each level evaluates only its new nodes, the trapezoidal estimates are then extrapolated into a Romberg table,
+    // sum_range(grid, first_level, begin, end) returns a compensated sum over a range of nodes of the level
+    template <typename Sum, typename ...T>
+    result integrate_levels(const std::tuple<variable_integration_info<T>...>& info, const settings& configuration, Sum&& sum_range){
+        static_assert((std::is_floating_point_v<T> && ...), "Romberg integration requires floating point variables");
+
+        constexpr auto dimensions = sizeof...(T);
+
+        // check whenever we have to swap integration range
+        level_grid<dimensions> grid;
+        std::size_t dimension = 0;
+        const auto initialize_dimension = [&](const auto& info_struct){
+            auto [from, to, steps] = info_struct;
+            if (from > to)
+                std::swap(from, to);
+
+            grid.from[dimension] = static_cast<double>(from);
+            grid.width[dimension] = static_cast<double>(to) - static_cast<double>(from);
+            grid.intervals[dimension++] = std::max(1ul, steps);
+        };
+        std::apply([&](const auto& ...info_struct){ (initialize_dimension(info_struct), ...); }, info);
+
+        std::tuple<double, double> sum = {0.0, 0.0};
+        std::vector<double> previous_row;
+        std::vector<double> current_row;
+
+        result output;
+        for (unsigned int level = 0; level <= configuration.max_level; level++){
+
+            if (level > 0){
+                auto next = grid;
+                for (auto& count : next.intervals)
+                    count *= 2;
+
+                if (next.size() > configuration.max_evaluations)
+                    break;
+                grid = next;
+            }
+
+            const auto [new_sum, compensation] = sum_range(grid, level == 0, 0ul, grid.size());
+            sum = mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(sum, new_sum), -compensation);
+
+            // extrapolate the new trapezoidal estimate using all previous levels, the error expansion contains only even
+            // powers of the step size because all dimensions are refined at the same rate
+            current_row.assign(1, (std::get<0>(sum) - std::get<1>(sum)) * grid.cell_volume());
+            for (std::size_t column = 1; column <= level; column++){
+                const double factor = std::pow(4.0, column) - 1;
+                current_row.push_back(current_row[column - 1] + (current_row[column - 1] - previous_row[column - 1]) / factor);
+            }
+
+            output.error = level > 0 ? std::fabs(current_row.back() - previous_row.back()) : std::fabs(current_row.back());
+            output.value = current_row.back();
+            output.evaluations = grid.size();
+            output.level = level;
+
+            std::swap(previous_row, current_row);
+
+            if (level > 1 && output.error <= std::max(configuration.absolute, configuration.relative * std::fabs(output.value)))
+                break;
+        }
+
+        return output;
+    }
+
+    // used to approximate functions given by any callable with floating point parameters using Romberg integration,
+    // the cost is roughly the cost of the finest trapezoidal pass since no node is evaluated twice
+    template <typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::romberg::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return integrate_levels(info_tuple, configuration, [&](const auto& grid, bool first_level, unsigned long int begin, unsigned long int end){
+                return sum_new_nodes<T...>(function, grid, first_level, begin, end);
+            });
+        }(info);
+    }
+
+    // used to approximate functions given by any callable using multiple threads, new nodes of every level are summed
+    // in chunks which are merged in a fixed order, results are reproducible regardless of the number of threads
+    template <typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::romberg::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return integrate_levels(info_tuple, configuration, [&](const auto& grid, bool first_level, unsigned long int, unsigned long int total){
+                const double new_sum = mz::approx::execution::reduce_chunks(policy, total, [&](unsigned long int begin, unsigned long int end){
+                    return sum_new_nodes<T...>(function, grid, first_level, begin, end);
+                });
+                return std::tuple<double, double>{new_sum, 0.0};
+            });
+        }(info);
+    }
+
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::romberg::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+    // used to approximate functions using multiple threads
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::romberg::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+}
+
+#endif
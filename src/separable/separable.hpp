@@ -0,0 +1,98 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_SEPARABLE_HPP
+#define APPROX_SEPARABLE_HPP
+
+#include <type_traits>
+#include <utility>
+#include <tuple>
+
+namespace mz::approx::separable {
+
+    // integrand given as f_1(x_1) + f_2(x_2) + ..., each term is integrated along its own dimension only
+    template <typename ...F>
+    struct sum{
+        constexpr explicit sum(F ...terms): functions(std::move(terms)...){}
+
+        std::tuple<F...> functions;
+    };
+
+    // integrand given as f_1(x_1) * f_2(x_2) * ..., each factor is integrated along its own dimension only
+    template <typename ...F>
+    struct product{
+        constexpr explicit product(F ...factors): functions(std::move(factors)...){}
+
+        std::tuple<F...> functions;
+    };
+
+    // integrand given as f(x) -> g(y) -> ... -> double, each stage is called once per coordinate of its dimension
+    // and the callable it returns is reused for all points sharing the outer coordinates
+    template <typename F>
+    struct curried{
+        constexpr explicit curried(F stage): function(std::move(stage)){}
+
+        F function;
+    };
+
+    // type of the single parameter of a per dimension function
+    template <typename F>
+    using argument_of = std::tuple_element_t<0, typename mz::approx::internals::callable_traits_of<F>::template tuple_of<std::type_identity_t>>;
+
+    // parameters of all stages of a curried function, the chain ends once a stage returns an arithmetic value
+    template <typename F, typename = void>
+    struct curried_arguments{
+        using type = std::tuple<>;
+    };
+
+    template <typename F>
+    struct curried_arguments<F, std::enable_if_t<!std::is_arithmetic_v<F>>>{
+        using type = decltype(std::tuple_cat(std::declval<std::tuple<argument_of<F>>>(),
+                                             std::declval<typename curried_arguments<std::invoke_result_t<const F&, const argument_of<F>&>>::type>()));
+    };
+
+    template <template <typename> class W, typename Arguments>
+    struct wrap_arguments;
+
+    template <template <typename> class W, typename ...T>
+    struct wrap_arguments<W, std::tuple<T...>>{
+        using type = mz::approx::internals::make_tuple_of<W, T...>;
+    };
+
+    template <typename T>
+    struct traits{
+        static constexpr bool is_separable = false;
+    };
+
+    template <typename ...F>
+    struct traits<sum<F...>>{
+        static constexpr bool is_separable = true;
+
+        template <template <typename> class W>
+        using tuple_of = mz::approx::internals::make_tuple_of<W, argument_of<F>...>;
+    };
+
+    template <typename ...F>
+    struct traits<product<F...>>{
+        static constexpr bool is_separable = true;
+
+        template <template <typename> class W>
+        using tuple_of = mz::approx::internals::make_tuple_of<W, argument_of<F>...>;
+    };
+
+    template <typename F>
+    struct traits<curried<F>>{
+        static constexpr bool is_separable = true;
+
+        template <template <typename> class W>
+        using tuple_of = typename wrap_arguments<W, typename curried_arguments<F>::type>::type;
+    };
+
+    template <typename T>
+    inline constexpr bool is_separable_v = traits<std::remove_cvref_t<T>>::is_separable;
+
+}
+
+#endif
@@ -0,0 +1,297 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_SHARD_HPP
+#define APPROX_SHARD_HPP
+
+#include <system_error>
+#include <filesystem>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+#include <typeinfo>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <array>
+#include <tuple>
+#include <bit>
+
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace mz::approx::shard {
+
+    // a sharded job splits the flattened point index space of a Riemann sum into a fixed number of segments, any number
+    // of processes sharing the work directory claim segments one by one and every segment is summed by a single Kahan
+    // chain which is checkpointed to its own file, a preempted segment is resumed from its last checkpoint by the next
+    // process which claims it, the result depends only on the number of segments, never on the number of processes nor on
+    // the points at which they were interrupted
+    struct job{
+        std::string directory;
+        unsigned long int segments = 64;
+        // number of points evaluated between two checkpoints of a segment
+        unsigned long int checkpoint_interval = 1ul << 24;
+    };
+
+    // checkpoint files are little endian and hold a single segment state:
+    //
+    //   offset  size  field
+    //   0       8     magic, the characters "APXSHRD1"
+    //   8       8     fingerprint of the grid, method and number of segments
+    //   16      8     segment
+    //   24      8     segments
+    //   32      8     begin, first point index of the segment
+    //   40      8     end, one past the last point index of the segment
+    //   48      8     next, first point index which was not summed yet
+    //   56      8     sum, float64
+    //   64      8     compensation, float64
+    inline constexpr std::array<char, 8> checkpoint_magic = {'A', 'P', 'X', 'S', 'H', 'R', 'D', '1'};
+
+    struct segment_state{
+        std::uint64_t fingerprint = 0;
+        std::uint64_t segment = 0;
+        std::uint64_t segments = 0;
+        std::uint64_t begin = 0;
+        std::uint64_t end = 0;
+        std::uint64_t next = 0;
+        double sum = 0;
+        double compensation = 0;
+
+        bool is_complete() const{
+            return next == end;
+        }
+    };
+
+    inline std::filesystem::path checkpoint_path(const job& configuration, std::uint64_t segment){
+        return std::filesystem::path(configuration.directory) / ("segment-" + std::to_string(segment) + ".ckpt");
+    }
+
+    inline std::filesystem::path lock_path(const job& configuration, std::uint64_t segment){
+        return std::filesystem::path(configuration.directory) / ("segment-" + std::to_string(segment) + ".lock");
+    }
+
+    // FNV-1a hash over raw bytes, used to tell checkpoints of different jobs apart
+    inline std::uint64_t hash_bytes(std::uint64_t hash, const void* data, std::size_t size){
+        const auto bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        return hash;
+    }
+
+    template <typename Method, typename ...T>
+    std::uint64_t fingerprint(const std::tuple<mz::approx::riemann::variable_integration_info<T>...>& info, std::uint64_t segments){
+
+        std::uint64_t hash = 14695981039346656037ull;
+        const std::string method = typeid(Method).name();
+        hash = hash_bytes(hash, method.data(), method.size());
+        hash = hash_bytes(hash, &segments, sizeof(segments));
+
+        std::apply([&](const auto& ...info_struct){
+            ((hash = hash_bytes(hash, &info_struct.from, sizeof(info_struct.from)),
+              hash = hash_bytes(hash, &info_struct.to, sizeof(info_struct.to)),
+              hash = hash_bytes(hash, &info_struct.steps, sizeof(info_struct.steps))), ...);
+        }, info);
+
+        return hash;
+    }
+
+    // first point index of a segment, equal to size * segment / segments but split into the quotient and the remainder
+    // of the size so huge grids do not overflow as long as there are fewer than 2^32 segments
+    inline std::uint64_t segment_bound(std::uint64_t size, std::uint64_t segments, std::uint64_t segment){
+        return size / segments * segment + size % segments * segment / segments;
+    }
+
+    // returns false if the segment has no checkpoint yet
+    inline bool read_checkpoint(const job& configuration, std::uint64_t segment, segment_state& state){
+        const auto path = checkpoint_path(configuration, segment);
+
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+
+        std::array<char, 8> magic{};
+        stream.read(magic.data(), magic.size());
+        stream.read(reinterpret_cast<char*>(&state), sizeof(state));
+
+        if (!stream || magic != checkpoint_magic)
+            throw std::runtime_error(path.string() + " is not a checkpoint file");
+
+        return true;
+    }
+
+    // the state is written to a temporary file which then replaces the checkpoint, a checkpoint is therefore either the
+    // previous or the new state even if the process is killed while writing
+    inline void write_checkpoint(const job& configuration, const segment_state& state){
+        static_assert(sizeof(segment_state) == 64, "segment state has to match the checkpoint layout");
+
+        if constexpr (std::endian::native != std::endian::little)
+            throw std::runtime_error("checkpoint files are little endian, big endian hosts are not supported");
+
+        const auto path = checkpoint_path(configuration, state.segment);
+        const auto temporary = path.string() + ".tmp";
+
+        const int descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0)
+            throw std::system_error(errno, std::generic_category(), "cannot create " + temporary);
+
+        std::array<char, 8 + sizeof(segment_state)> buffer;
+        std::memcpy(buffer.data(), checkpoint_magic.data(), checkpoint_magic.size());
+        std::memcpy(buffer.data() + checkpoint_magic.size(), &state, sizeof(state));
+
+        if (::write(descriptor, buffer.data(), buffer.size()) != static_cast<ssize_t>(buffer.size()) || ::fsync(descriptor) < 0){
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "cannot write " + temporary);
+        }
+        ::close(descriptor);
+
+        if (std::rename(temporary.c_str(), path.c_str()) != 0)
+            throw std::system_error(errno, std::generic_category(), "cannot replace " + path.string());
+    }
+
+    // exclusive claim of a segment, the kernel releases the lock when the owning process dies so segments of preempted
+    // processes can be claimed again
+    class segment_lock{
+    public:
+        explicit segment_lock(const std::filesystem::path& path){
+            descriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (descriptor < 0)
+                throw std::system_error(errno, std::generic_category(), "cannot open " + path.string());
+
+            if (::flock(descriptor, LOCK_EX | LOCK_NB) < 0){
+                const int error = errno;
+                ::close(descriptor);
+                descriptor = -1;
+
+                if (error != EWOULDBLOCK)
+                    throw std::system_error(error, std::generic_category(), "cannot lock " + path.string());
+            }
+        }
+
+        segment_lock(const segment_lock&) = delete;
+        segment_lock& operator=(const segment_lock&) = delete;
+
+        ~segment_lock(){
+            if (descriptor >= 0)
+                ::close(descriptor);
+        }
+
+        bool is_owned() const{
+            return descriptor >= 0;
+        }
+
+    private:
+        int descriptor = -1;
+    };
+
+    // used to take part in a sharded Riemann sum, segments which are neither complete nor claimed by another process are
+    // summed until none is left, returns the number of points evaluated by this call, may be called by many processes,
+    // every checkpoint holds the partial result of the accumulator which is resumed from it by the next process
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    unsigned long int run(const job& configuration, F&& function, const typename Traits::template tuple_of<mz::approx::riemann::variable_integration_info>& info){
+
+        constexpr auto calculate_delta = [](auto&& ...dimension_data){
+            return (static_cast<double>(dimension_data.step_size) * ...);
+        };
+
+        const auto point_data = mz::approx::internals::initialize_point_data<Method>(info);
+        const mz::approx::internals::grid_cursor grid(point_data);
+        const double delta = std::apply(calculate_delta, point_data);
+
+        const std::uint64_t segments = std::max(1ul, configuration.segments);
+        const std::uint64_t size = grid.size();
+        const auto job_fingerprint = fingerprint<Method>(info, segments);
+
+        std::filesystem::create_directories(configuration.directory);
+
+        unsigned long int evaluated = 0;
+        for (std::uint64_t segment = 0; segment < segments; segment++){
+
+            const segment_lock lock(lock_path(configuration, segment));
+            if (!lock.is_owned())
+                continue;
+
+            segment_state state{job_fingerprint, segment, segments, segment_bound(size, segments, segment), segment_bound(size, segments, segment + 1)};
+            state.next = state.begin;
+
+            if (read_checkpoint(configuration, segment, state) && state.fingerprint != job_fingerprint)
+                throw std::runtime_error(checkpoint_path(configuration, segment).string() + " belongs to a different job");
+
+            while (!state.is_complete()){
+                const auto last = std::min(state.end, state.next + std::max(1ul, configuration.checkpoint_interval));
+
+                auto sum = mz::approx::accumulator::resume<Accumulator>({state.sum, state.compensation});
+                grid.for_each(state.next, last, [&](const auto& ...coordinates){
+                    sum.add(function(coordinates...) * delta);
+                });
+
+                std::tie(state.sum, state.compensation) = sum.partial();
+                evaluated += last - state.next;
+                state.next = last;
+
+                write_checkpoint(configuration, state);
+            }
+
+            // empty segments still leave a checkpoint so merge can tell them apart from missing ones
+            if (state.begin == state.end)
+                write_checkpoint(configuration, state);
+        }
+
+        return evaluated;
+    }
+
+    // used to take part in a sharded Riemann sum of a function given by std::function
+    template <typename Method, typename Accumulator = mz::approx::accumulator::kahan, typename Arg, typename ...Args,
+              std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    unsigned long int run(const job& configuration, const std::function<double(Arg, Args...)>& function,
+                          const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, Arg,Args...>& info){
+
+        return run<Method, Accumulator>(configuration, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
+    }
+
+    // used to merge the checkpoints of all segments of a finished job, segments are merged in their order so the result
+    // is the same for any number of processes, throws if a segment is missing, unfinished or belongs to a different job
+    inline double merge(const job& configuration){
+
+        // segment sums are added to a double-double sum using Knuth's error free transformation, the rounding errors of
+        // the merge are kept in its low part so the result is the one of a single Kahan chain over all points, except
+        // for sums lying next to a rounding boundary, rather than depending on where the segments were cut
+        double high = 0;
+        double low = 0;
+        const auto add = [&](double value){
+            const double sum = high + value;
+            const double rounded = sum - high;
+            low += (high - (sum - rounded)) + (value - rounded);
+            high = sum;
+        };
+
+        std::uint64_t job_fingerprint = 0;
+
+        const std::uint64_t segments = std::max(1ul, configuration.segments);
+        for (std::uint64_t segment = 0; segment < segments; segment++){
+            segment_state state;
+            if (!read_checkpoint(configuration, segment, state) || !state.is_complete())
+                throw std::runtime_error("segment " + std::to_string(segment) + " of " + configuration.directory + " is not finished");
+
+            if (segment == 0)
+                job_fingerprint = state.fingerprint;
+
+            if (state.fingerprint != job_fingerprint || state.segment != segment || state.segments != segments)
+                throw std::runtime_error(checkpoint_path(configuration, segment).string() + " belongs to a different job");
+
+            add(state.sum);
+            add(-state.compensation);
+        }
+
+        return high + low;
+    }
+
+}
+
+#endif
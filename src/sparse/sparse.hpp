@@ -0,0 +1,273 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_SPARSE_HPP
+#define APPROX_SPARSE_HPP
+
+#include <functional>
+#include <algorithm>
+#include <numbers>
+#include <numeric>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <cmath>
+#include <map>
+
+namespace mz::approx::sparse {
+
+    // nodes of the nested Clenshaw-Curtis rules are identified by their position on the finest possible grid
+    // x = -cos(pi * key / node_scale), so the same node keeps the same key at every level
+    inline constexpr unsigned int max_level = 30;
+    inline constexpr std::uint32_t node_scale = std::uint32_t(1) << max_level;
+
+    struct rule_node{
+        std::uint32_t key;
+        double weight;
+    };
+
+    // Clenshaw-Curtis rule on [-1, 1] of a given level, the first level is the midpoint rule
+    // every next level doubles the number of intervals so all nodes of the previous levels are reused
+    inline std::vector<rule_node> clenshaw_curtis(unsigned int level){
+        if (level == 1)
+            return {{node_scale / 2, 2.0}};
+
+        const std::uint32_t intervals = std::uint32_t(1) << (level - 1);
+        const std::uint32_t spacing = node_scale / intervals;
+
+        std::vector<rule_node> nodes;
+        nodes.reserve(intervals + 1);
+
+        for (std::uint32_t j = 0; j <= intervals; j++){
+            double sum = 0;
+            for (std::uint32_t k = 1; k <= intervals / 2; k++){
+                const double b = (2 * k == intervals) ? 1.0 : 2.0;
+                sum += b / (4.0 * k * k - 1) * std::cos(2 * std::numbers::pi * k * j / intervals);
+            }
+
+            const double c = (j == 0 || j == intervals) ? 1.0 : 2.0;
+            nodes.push_back({j * spacing, c / intervals * (1 - sum)});
+        }
+
+        return nodes;
+    }
+
+    inline double node_position(std::uint32_t key){
+        return -std::cos(std::numbers::pi * static_cast<double>(key) / node_scale);
+    }
+
+    template <typename Type>
+    struct variable_integration_info{
+        Type from = 0;
+        Type to = 0;
+    };
+
+    // refinement stops once two consecutive levels differ by less than max(absolute, relative * |value|)
+    struct settings{
+        unsigned int max_level = 6;
+        double absolute = 1e-10;
+        double relative = 1e-10;
+    };
+
+    struct result{
+        double value = 0;
+        double error = 0;
+        unsigned long int evaluations = 0;
+        unsigned int level = 0;
+    };
+
+    template <std::size_t Dimensions>
+    using node_key = std::array<std::uint32_t, Dimensions>;
+
+    constexpr double binomial(unsigned int n, unsigned int k){
+        double value = 1;
+        for (unsigned int i = 1; i <= k; i++)
+            value = value * (n - k + i) / i;
+        return value;
+    }
+
+    // weights of the Smolyak construction of a given level, obtained with the combination technique and merged per node
+    template <std::size_t Dimensions>
+    std::map<node_key<Dimensions>, double> smolyak_weights(unsigned int level, const std::vector<std::vector<rule_node>>& rules){
+
+        std::map<node_key<Dimensions>, double> weights;
+
+        const unsigned int q = level + Dimensions - 1;
+        std::array<unsigned int, Dimensions> levels;
+
+        // add the tensor product of 1D rules of given levels multiplied by its combination coefficient
+        const auto add_tensor_product = [&](unsigned int total){
+            const unsigned int k = q - total;
+            const double coefficient = (k % 2 ? -1.0 : 1.0) * binomial(Dimensions - 1, k);
+
+            std::array<std::size_t, Dimensions> position{};
+            for (bool done = false; !done;){
+                node_key<Dimensions> key;
+                double weight = coefficient;
+                for (std::size_t dimension = 0; dimension < Dimensions; dimension++){
+                    const auto& node = rules[levels[dimension]][position[dimension]];
+                    key[dimension] = node.key;
+                    weight *= node.weight;
+                }
+                weights[key] += weight;
+
+                done = true;
+                for (std::size_t dimension = 0; dimension < Dimensions; dimension++){
+                    if (++position[dimension] < rules[levels[dimension]].size()){
+                        done = false;
+                        break;
+                    }
+                    position[dimension] = 0;
+                }
+            }
+        };
+
+        // enumerate multi indices with every entry at least 1 and q - d + 1 <= |l| <= q
+        const auto enumerate = [&](const auto& self, std::size_t dimension, unsigned int total) -> void{
+            if (dimension == Dimensions){
+                if (total + Dimensions >= q + 1)
+                    add_tensor_product(total);
+                return;
+            }
+
+            const unsigned int remaining = Dimensions - dimension - 1;
+            for (unsigned int l = 1; total + l + remaining <= q; l++){
+                levels[dimension] = l;
+                self(self, dimension + 1, total + l);
+            }
+        };
+
+        enumerate(enumerate, 0, 0);
+        return weights;
+    }
+
+    // evaluates the Smolyak rules of increasing levels, nodes are evaluated once and reused by all the following levels,
+    // evaluate_nodes(keys) returns outputs for a vector of new node keys and is used to distribute work over threads
+    template <typename Evaluate, typename ...T>
+    result integrate_levels(const std::tuple<variable_integration_info<T>...>& info, const settings& configuration, Evaluate&& evaluate_nodes){
+        static_assert((std::is_floating_point_v<T> && ...), "sparse grid integration requires floating point variables");
+
+        constexpr auto dimensions = sizeof...(T);
+        const auto last_level = std::min(std::max(1u, configuration.max_level), max_level);
+
+        const double volume = std::apply([](const auto& ...info_struct){
+            return ((std::fabs(static_cast<double>(info_struct.to) - static_cast<double>(info_struct.from)) / 2) * ... * 1.0);
+        }, info);
+
+        std::vector<std::vector<rule_node>> rules(last_level + 1);
+        std::map<node_key<dimensions>, double> outputs;
+
+        result output;
+        for (unsigned int level = 1; level <= last_level; level++){
+            rules[level] = clenshaw_curtis(level);
+
+            const auto weights = smolyak_weights<dimensions>(level, rules);
+
+            // evaluate only the nodes which were not needed by the previous levels
+            std::vector<node_key<dimensions>> new_nodes;
+            for (const auto& [key, _] : weights)
+                if (!outputs.contains(key))
+                    new_nodes.push_back(key);
+
+            const auto new_outputs = evaluate_nodes(new_nodes);
+            for (std::size_t index = 0; index < new_nodes.size(); index++)
+                outputs.emplace(new_nodes[index], new_outputs[index]);
+
+            // nodes are visited in the key order so the result does not depend on the order of evaluation
+            std::tuple<double, double> sum = {0.0, 0.0};
+            for (const auto& [key, weight] : weights)
+                sum = mz::approx::internals::kahan_sum(sum, weight * outputs.at(key));
+
+            const double value = (std::get<0>(sum) - std::get<1>(sum)) * volume;
+
+            output.error = level > 1 ? std::fabs(value - output.value) : std::fabs(value);
+            output.value = value;
+            output.evaluations = outputs.size();
+            output.level = level;
+
+            if (level > 1 && output.error <= std::max(configuration.absolute, configuration.relative * std::fabs(value)))
+                break;
+        }
+
+        return output;
+    }
+
+    // maps the node onto the integration box and evaluates the function there
+    template <typename F, typename ...T>
+    auto make_node_evaluator(F& function, const std::tuple<variable_integration_info<T>...>& info){
+
+        const auto centre = std::apply([](const auto& ...info_struct){
+            return std::array<double, sizeof...(T)>{std::midpoint(static_cast<double>(info_struct.from), static_cast<double>(info_struct.to))...};
+        }, info);
+
+        const auto half_width = std::apply([](const auto& ...info_struct){
+            return std::array<double, sizeof...(T)>{std::fabs(static_cast<double>(info_struct.to) - static_cast<double>(info_struct.from)) / 2 ...};
+        }, info);
+
+        return [&function, centre, half_width](const node_key<sizeof...(T)>& key){
+            return [&]<size_t ...I>(std::index_sequence<I...>){
+                return static_cast<double>(function(static_cast<T>(centre[I] + half_width[I] * node_position(key[I]))...));
+            }(std::index_sequence_for<T...>());
+        };
+    }
+
+    // used to approximate functions given by any callable with floating point parameters using Smolyak sparse grids
+    // built from nested Clenshaw-Curtis rules, levels are refined until two consecutive ones agree within the tolerance
+    template <typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::sparse::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        const auto evaluate = make_node_evaluator(function, info);
+
+        return integrate_levels(info, configuration, [&](const auto& nodes){
+            std::vector<double> outputs;
+            outputs.reserve(nodes.size());
+            for (const auto& node : nodes)
+                outputs.push_back(evaluate(node));
+            return outputs;
+        });
+    }
+
+    // used to approximate functions given by any callable using multiple threads, new nodes of every level are
+    // evaluated in parallel while the summation order stays fixed
+    template <typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::sparse::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        const auto evaluate = make_node_evaluator(function, info);
+
+        return integrate_levels(info, configuration, [&](const auto& nodes){
+            std::vector<double> outputs(nodes.size());
+            mz::approx::execution::map_chunks(policy, nodes.size(), [&](unsigned long int begin, unsigned long int end){
+                for (auto index = begin; index < end; index++)
+                    outputs[index] = evaluate(nodes[index]);
+                return end - begin;
+            });
+            return outputs;
+        });
+    }
+
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::sparse::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+    // used to approximate functions using multiple threads
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::sparse::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+}
+
+#endif
@@ -0,0 +1,322 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_TANH_SINH_HPP
+#define APPROX_TANH_SINH_HPP
+
+#include <functional>
+#include <algorithm>
+#include <numbers>
+#include <limits>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <cmath>
+
+namespace mz::approx::tanh_sinh {
+
+    // ranges are mapped onto the whole real line by a double exponential substitution chosen by the kind of their bounds
+    enum class transform{
+        finite,         // tanh-sinh, x = c + r * tanh(pi/2 * sinh(t))
+        half_infinite,  // exp-sinh, x = a + exp(pi/2 * sinh(t))
+        infinite        // sinh-sinh, x = sinh(pi/2 * sinh(t))
+    };
+
+    // highest level of the cached tables, the step size of a level is 2^-level
+    inline constexpr unsigned int max_level = 10;
+
+    // the substituted integrand decays double exponentially so t is truncated to [-t_max, t_max]
+    inline constexpr double t_max = 6.0;
+
+    // node of a substitution on the unit scale, value is the distance from the nearest end for finite ranges and
+    // the offset from the bound otherwise, values are kept apart from the bounds to avoid cancellation near singularities
+    struct unit_node{
+        double t = 0;
+        double value = 0;
+        double weight = 0;
+    };
+
+    inline unit_node make_unit_node(transform kind, double t){
+        const double u = std::numbers::pi / 2 * std::sinh(t);
+        const double du = std::numbers::pi / 2 * std::cosh(t);
+
+        switch (kind){
+            case transform::finite:{
+                // 1 - tanh(|u|) and the derivative of tanh(u) are written in terms of exp(-2|u|)
+                const double e = std::exp(-2 * std::fabs(u));
+                return {t, 2 * e / (1 + e), du * 4 * e / ((1 + e) * (1 + e))};
+            }
+            case transform::half_infinite:{
+                const double y = std::exp(u);
+                return {t, y, du * y};
+            }
+            default:
+                return {t, std::sinh(u), du * std::cosh(u)};
+        }
+    }
+
+    // tables of nodes introduced by every level, level 0 holds all integer t and every next level the odd multiples
+    // of its step size, tables are built once per substitution and shared by all integrations
+    template <transform Kind>
+    const std::array<std::vector<unit_node>, max_level + 1>& unit_tables(){
+        static const auto tables = []{
+            std::array<std::vector<unit_node>, max_level + 1> levels;
+
+            for (unsigned int level = 0; level <= max_level; level++){
+                const double h = std::ldexp(1.0, -static_cast<int>(level));
+                const long int last = static_cast<long int>(t_max / h);
+
+                for (long int index = -last; index <= last; index++)
+                    if (level == 0 || index % 2 != 0)
+                        levels[level].push_back(make_unit_node(Kind, index * h));
+            }
+
+            return levels;
+        }();
+
+        return tables;
+    }
+
+    template <typename Type>
+    struct variable_integration_info{
+        Type from = 0;
+        Type to = 0;
+    };
+
+    // refinement stops once two consecutive levels differ by less than max(absolute, relative * |value|) or when
+    // the next level would exceed the evaluation budget, levels above the cached tables are never used
+    struct settings{
+        unsigned int max_level = 8;
+        double absolute = 1e-10;
+        double relative = 1e-10;
+        unsigned long int max_evaluations = 10'000'000;
+    };
+
+    struct result{
+        double value = 0;
+        double error = 0;
+        unsigned long int evaluations = 0;
+        unsigned int level = 0;
+    };
+
+    // nodes of a single dimension gathered from all levels so far, nodes which coincide with a bound or whose weight
+    // underflows are dropped so the integrand is never called at a singular end point
+    template <typename Type>
+    struct dimension_nodes{
+        transform kind = transform::finite;
+        double from = 0;
+        double to = 0;
+        double sign = 1;
+
+        std::vector<Type> coordinates;
+        std::vector<double> weights;
+        std::vector<unsigned int> levels;
+
+        const std::vector<unit_node>& table(unsigned int level) const{
+            if (kind == transform::finite)
+                return unit_tables<transform::finite>()[level];
+            if (kind == transform::half_infinite)
+                return unit_tables<transform::half_infinite>()[level];
+            return unit_tables<transform::infinite>()[level];
+        }
+
+        // upper bound of the number of nodes after adding the given level
+        std::size_t size_with(unsigned int level) const{
+            return coordinates.size() + table(level).size();
+        }
+
+        void add_level(unsigned int level){
+            for (const auto& node : table(level)){
+                double x;
+                double weight = node.weight;
+
+                if (kind == transform::finite){
+                    const double half_width = (to - from) / 2;
+                    x = node.t < 0 ? from + half_width * node.value : to - half_width * node.value;
+                    weight *= half_width;
+                }
+                else if (kind == transform::half_infinite)
+                    x = from + sign * node.value;
+                else
+                    x = node.value;
+
+                const auto coordinate = static_cast<Type>(x);
+                if (weight == 0 || !std::isfinite(weight) || !std::isfinite(coordinate)
+                    || (std::isfinite(from) && coordinate == static_cast<Type>(from)) || (std::isfinite(to) && coordinate == static_cast<Type>(to)))
+                    continue;
+
+                coordinates.push_back(coordinate);
+                weights.push_back(weight);
+                levels.push_back(level);
+            }
+        }
+    };
+
+    // picks the substitution of a dimension from its bounds, ranges with swapped bounds are integrated in the ascending order
+    template <typename Type>
+    dimension_nodes<Type> make_dimension(const variable_integration_info<Type>& info){
+        static_assert(std::is_floating_point_v<Type>, "tanh-sinh integration requires floating point variables");
+
+        auto [from, to] = info;
+        if (from > to)
+            std::swap(from, to);
+
+        dimension_nodes<Type> nodes;
+        nodes.from = static_cast<double>(from);
+        nodes.to = static_cast<double>(to);
+
+        if (std::isinf(nodes.from) && std::isinf(nodes.to))
+            nodes.kind = transform::infinite;
+        else if (std::isinf(nodes.to))
+            nodes.kind = transform::half_infinite;
+        else if (std::isinf(nodes.from)){
+            // the exp-sinh substitution is mirrored around the finite upper bound
+            nodes.kind = transform::half_infinite;
+            nodes.from = static_cast<double>(to);
+            nodes.to = static_cast<double>(from);
+            nodes.sign = -1;
+        }
+
+        return nodes;
+    }
+
+    // sums weighted outputs of the points in [begin, end) of the tensor product of the dimension nodes, only points
+    // with at least one coordinate introduced by the given level are evaluated
+    template <typename ...T, typename F>
+    std::tuple<double, double> sum_level(F& function, const std::tuple<dimension_nodes<T>...>& dimensions, unsigned int level,
+                                         unsigned long int begin, unsigned long int end){
+
+        constexpr auto size = sizeof...(T);
+
+        const auto extents = std::apply([](const auto& ...nodes){
+            return std::array<unsigned long int, size>{nodes.coordinates.size()...};
+        }, dimensions);
+
+        std::array<unsigned long int, size> position;
+        for (std::size_t dimension = 0, rest = begin; dimension < size; dimension++){
+            position[dimension] = rest % extents[dimension];
+            rest /= extents[dimension];
+        }
+
+        std::tuple<double, double> result = {0.0, 0.0};
+        for (auto index = begin; index < end; index++){
+
+            const auto [is_new, weight] = [&]<size_t ...I>(std::index_sequence<I...>){
+                return std::make_tuple(((std::get<I>(dimensions).levels[position[I]] == level) || ...),
+                                       (1.0 * ... * std::get<I>(dimensions).weights[position[I]]));
+            }(std::index_sequence_for<T...>());
+
+            if (is_new){
+                const auto output = [&]<size_t ...I>(std::index_sequence<I...>){
+                    return static_cast<double>(function(std::get<I>(dimensions).coordinates[position[I]]...));
+                }(std::index_sequence_for<T...>());
+
+                result = mz::approx::internals::kahan_sum(result, output * weight);
+            }
+
+            for (std::size_t dimension = 0; dimension < size; dimension++){
+                if (++position[dimension] < extents[dimension])
+                    break;
+                position[dimension] = 0;
+            }
+        }
+
+        return result;
+    }
+
+    // refines all dimensions level by level, sums of the weighted outputs are carried forward so each level evaluates
+    // only its new points, sum_range(dimensions, level, begin, end) returns a compensated sum over a range of points
+    template <typename Sum, typename ...T>
+    result integrate_levels(const std::tuple<variable_integration_info<T>...>& info, const settings& configuration, Sum&& sum_range){
+
+        auto dimensions = std::apply([](const auto& ...info_struct){ return std::make_tuple(make_dimension(info_struct)...); }, info);
+
+        // empty ranges have no area
+        const bool is_empty = std::apply([](const auto& ...nodes){ return ((nodes.from == nodes.to) || ...); }, dimensions);
+        if (is_empty)
+            return {};
+
+        const auto last_level = std::min(configuration.max_level, max_level);
+
+        std::tuple<double, double> sum = {0.0, 0.0};
+
+        result output;
+        for (unsigned int level = 0; level <= last_level; level++){
+
+            const auto next_size = std::apply([level](const auto& ...nodes){ return (1ul * ... * nodes.size_with(level)); }, dimensions);
+            if (level > 0 && next_size > configuration.max_evaluations)
+                break;
+
+            std::apply([level](auto& ...nodes){ (nodes.add_level(level), ...); }, dimensions);
+
+            const auto size = std::apply([](const auto& ...nodes){ return (1ul * ... * nodes.coordinates.size()); }, dimensions);
+
+            const auto [new_sum, compensation] = sum_range(dimensions, level, 0ul, size);
+            sum = mz::approx::internals::kahan_sum(mz::approx::internals::kahan_sum(sum, new_sum), -compensation);
+
+            const double value = (std::get<0>(sum) - std::get<1>(sum)) * std::pow(std::ldexp(1.0, -static_cast<int>(level)), sizeof...(T));
+
+            output.error = level > 0 ? std::fabs(value - output.value) : std::fabs(value);
+            output.value = value;
+            output.evaluations = size;
+            output.level = level;
+
+            if (level > 1 && output.error <= std::max(configuration.absolute, configuration.relative * std::fabs(value)))
+                break;
+        }
+
+        return output;
+    }
+
+    // used to approximate functions given by any callable with floating point parameters using the double exponential
+    // substitution, end point singularities and infinite bounds given by std::numeric_limits<T>::infinity() are supported
+    template <typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(F&& function, const typename Traits::template tuple_of<mz::approx::tanh_sinh::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return integrate_levels(info_tuple, configuration, [&](const auto& dimensions, unsigned int level, unsigned long int begin, unsigned long int end){
+                return sum_level<T...>(function, dimensions, level, begin, end);
+            });
+        }(info);
+    }
+
+    // used to approximate functions given by any callable using multiple threads, new points of every level are summed
+    // in chunks which are merged in a fixed order, results are reproducible regardless of the number of threads
+    template <typename F, typename Traits = mz::approx::internals::callable_traits_of<F>, std::enable_if_t<Traits::is_integrand, bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::tanh_sinh::variable_integration_info>& info,
+                       const settings& configuration = {}){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return integrate_levels(info_tuple, configuration, [&](const auto& dimensions, unsigned int level, unsigned long int, unsigned long int total){
+                const double new_sum = mz::approx::execution::reduce_chunks(policy, total, [&](unsigned long int begin, unsigned long int end){
+                    return sum_level<T...>(function, dimensions, level, begin, end);
+                });
+                return std::tuple<double, double>{new_sum, 0.0};
+            });
+        }(info);
+    }
+
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::tanh_sinh::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+    // used to approximate functions using multiple threads
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    result approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::tanh_sinh::variable_integration_info, Arg,Args...>& info,
+                       const settings& configuration = {}){
+
+        return approximate(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info, configuration);
+    }
+
+}
+
+#endif
@@ -17,72 +17,184 @@ namespace mz::approx::trapezoidal{
         const unsigned long int steps = 0;
     };
 
-    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
-    constexpr double approximate(const std::function<double(Arg, Args...)>& function,
-                                 const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info){
-
-        constexpr auto calculate_total_number_of_points = [](auto&& ...info_struct) {
-            return (info_struct.steps * ...);
+    // used to build the tensor grid of trapezoidal nodes, every dimension spans both ends of its range and each node
+    // carries a product of per dimension weights, half of the step size at both ends and the whole step size elsewhere
+    template <typename Arg, typename ...Args>
+    constexpr mz::approx::internals::grid_cursor<Arg, Args...> make_grid(const std::tuple<variable_integration_info<Arg>, variable_integration_info<Args>...>& info){
+
+        constexpr auto end_point_weights = [](const auto& dimension_data, unsigned long int index){
+            const auto step_size = static_cast<double>(dimension_data.step_size);
+            return (index == 0 || index + 1 == dimension_data.number_of_points) ? step_size / 2 : step_size;
         };
 
-        constexpr auto get_number_of_steps_in_first_dimension = [](auto&& head, auto&& ...tail){
-            return head.steps;
-        };
+        // pick each entry from info tuple and use it to initialize dimension data of a corresponding variable
+        auto point_data = mz::approx::internals::initialize_point_data<mz::approx::internals::from_starting_point>(info);
+
+        // every dimension needs both ends of its range
+        std::apply([](auto& ...dimension_data){ ((dimension_data.number_of_points++), ...); }, point_data);
+
+        return mz::approx::internals::grid_cursor<Arg, Args...>(point_data, end_point_weights);
+    }
 
-        constexpr auto initialize_dimension_data = []<typename T>(auto&& dimension_data, const mz::approx::trapezoidal::variable_integration_info<T>& info_struct){
-            auto& [current_coordinate, starting_position, stop_at, step_size, compensation] = dimension_data;
-            auto [from, to, steps] = info_struct;
+    // used to approximate functions given by any callable with arithmetic parameters, the callable is invoked directly
+    // with the coordinates of each node so cheap integrands can be inlined into the loop, every node is evaluated once
+    template <typename Accumulator = mz::approx::accumulator::naive, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_integrand, bool> = true>
+    constexpr double approximate(F&& function, const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
+
+        const auto grid = make_grid(info);
+
+        Accumulator result;
+        grid.for_each_weighted(0, grid.size(), [&](double weight, const auto& ...coordinates){
+
+            // add weighted output of the node to the result
+            result.add(function(coordinates...) * weight);
+        });
+
+        return result.total();
+    }
 
-            // check whenever we have to swap integration range
-            if (from > to)
-                std::swap(from, to);
+    // used to approximate functions given by any callable using multiple threads, each chunk of the grid is summed by the
+    // accumulator and the partial sums are merged in a fixed order, results are reproducible regardless of the number of threads
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_integrand, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
 
-            stop_at = to;
-            step_size = (to - from) / steps;
-            current_coordinate = starting_position = from;
-            return dimension_data;
+        const auto grid = make_grid(info);
+
+        const auto integrate_range = [&](unsigned long int begin, unsigned long int end){
+            Accumulator result;
+
+            grid.for_each_weighted(begin, end, [&](double weight, const auto& ...coordinates){
+                result.add(function(coordinates...) * weight);
+            });
+
+            return result.partial();
         };
 
-        constexpr auto calculate_delta = [](auto&& ...dimension_data){
-            return (static_cast<double>(dimension_data.step_size) * ...);
+        return mz::approx::execution::reduce_chunks(policy, grid.size(), integrate_range);
+    }
+
+    // used to approximate functions given by a batch integrand, it receives blocks of first dimension coordinates as spans
+    // together with the remaining coordinates as scalars and writes a block of double or float outputs at once which are
+    // then weighted and reduced by the accumulator, by default using a vectorized compensated sum
+    template <typename Accumulator = mz::approx::accumulator::lanes<>, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_batch_integrand, bool> = true>
+    constexpr double approximate(F&& function, const typename Traits::template batch_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
+
+        const auto grid = make_grid(info);
+
+        Accumulator result;
+        mz::approx::internals::for_each_batch(grid, 0, grid.size(), function, [&](const auto outputs, std::span<const double> weights, double outer_weight){
+            mz::approx::accumulator::add_block(result, outputs, weights, outer_weight);
+        });
+
+        return result.total();
+    }
+
+    // used to approximate functions given by a batch integrand using multiple threads
+    template <typename Accumulator = mz::approx::accumulator::lanes<>, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_batch_integrand, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                       const typename Traits::template batch_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
+
+        const auto grid = make_grid(info);
+
+        const auto integrate_range = [&](unsigned long int begin, unsigned long int end){
+            Accumulator result;
+            mz::approx::internals::for_each_batch(grid, begin, end, function, [&](const auto outputs, std::span<const double> weights, double outer_weight){
+                mz::approx::accumulator::add_block(result, outputs, weights, outer_weight);
+            });
+
+            return result.partial();
         };
 
-        const unsigned long int first_dimension_steps = std::apply( get_number_of_steps_in_first_dimension, info);
-        const unsigned long int total_number_of_points = std::apply(calculate_total_number_of_points , info);
+        return mz::approx::execution::reduce_chunks(policy, grid.size(), integrate_range);
+    }
 
-        using point_data_type = mz::approx::internals::make_tuple_of<mz::approx::internals::dimension_data, Arg, Args...>;
+    // used to prepare the weighted grid of the trapezoidal rule once so it can be executed against many integrands
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    constexpr mz::approx::plan::grid_plan<Arg, Args...> make_plan(const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info){
+        return mz::approx::plan::grid_plan<Arg, Args...>(make_grid<Arg, Args...>(info));
+    }
 
-        // pick each entry from info tuple and input them into the initialize_dimension_data function together with a default constructed dimension_data struct
-        point_data_type point_data = [&]<size_t... Is>(std::index_sequence<Is...>){
-            return std::make_tuple(initialize_dimension_data(typename std::tuple_element<Is, point_data_type>::type(), std::get<Is>(info))... );
-        }(std::make_index_sequence<std::tuple_size_v<point_data_type>>());
+    // used to approximate separable functions given as a separable::sum or separable::product of per dimension functions,
+    // which need only the sum of the steps evaluations, or as a separable::curried chain of per dimension stages
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool> = true>
+    constexpr double approximate(const Separable& function, const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
 
-        // calculate n-dimensional delta
-        const double delta = std::apply(calculate_delta, point_data);
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<T...>(info_tuple).template execute<Accumulator>(function);
+        }(info);
+    }
 
-        double result = 0.0;
-        for (unsigned long int current_point = 0; current_point < total_number_of_points;){
+    // used to approximate separable functions using multiple threads
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename Separable, std::enable_if_t<mz::approx::separable::is_separable_v<Separable>, bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const Separable& function,
+                       const typename mz::approx::separable::traits<Separable>::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
 
-            // get first output
-            const auto output_1 = std::apply(mz::approx::internals::bind_function_parameters<decltype(function), Arg, Args...>{function}, point_data)();
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<T...>(info_tuple).template execute<Accumulator>(policy, function);
+        }(info);
+    }
 
-            // advance point coordinates
-            std::apply(mz::approx::internals::advance_to_next_point<mz::approx::internals::greather_than, Arg, Args...>, point_data);
+    // used to approximate vector valued functions returning std::array, all components are integrated in a single sweep
+    // over the grid and each of them is accumulated using its own Kahan sum
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_vector_integrand, bool> = true>
+    constexpr auto approximate(F&& function, const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
 
-            // get second output
-            const auto output_2 = std::apply(mz::approx::internals::bind_function_parameters<decltype(function), Arg, Args...>{function}, point_data)();
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<T...>(info_tuple).template execute<Accumulator>(function);
+        }(info);
+    }
 
-            // check whenever we have advanced to the last point for the first variable if yes
-            // advance again to point to the first position again
-            if (!(++current_point % first_dimension_steps))
-                std::apply(mz::approx::internals::advance_to_next_point<mz::approx::internals::greather_than, Arg, Args...>, point_data);
+    // used to approximate vector valued functions returning std::array using multiple threads
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_vector_integrand, bool> = true>
+    auto approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                     const typename Traits::template tuple_of<mz::approx::trapezoidal::variable_integration_info>& info){
+
+        return [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            return make_plan<T...>(info_tuple).template execute<Accumulator>(policy, function);
+        }(info);
+    }
 
-            // add outputs to the result
-            result += ((output_1 + output_2) / 2) * delta;
+    // used to approximate functions writing several outputs into a span, results has to hold one entry per output
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_span_integrand, bool> = true>
+    constexpr void approximate(F&& function, const typename Traits::template span_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info, std::span<double> results){
 
-        }
+        [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            make_plan<T...>(info_tuple).template execute<Accumulator>(function, results);
+        }(info);
+    }
+
+    // used to approximate functions writing several outputs into a span using multiple threads
+    template <typename Accumulator = mz::approx::accumulator::kahan, typename F, typename Traits = mz::approx::internals::callable_traits_of<F>,
+              std::enable_if_t<Traits::is_span_integrand, bool> = true>
+    void approximate(const mz::approx::execution::parallel_policy& policy, F&& function,
+                     const typename Traits::template span_tuple_of<mz::approx::trapezoidal::variable_integration_info>& info, std::span<double> results){
+
+        [&]<typename ...T>(const std::tuple<variable_integration_info<T>...>& info_tuple){
+            make_plan<T...>(info_tuple).template execute<Accumulator>(policy, function, results);
+        }(info);
+    }
+
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    double approximate(const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info){
+
+        return approximate([&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
+    }
+
+    // used to approximate functions using multiple threads
+    template <typename Arg, typename ...Args, std::enable_if_t<mz::approx::internals::all_types_are_arithmetic<Arg, Args...>(), bool> = true>
+    double approximate(const mz::approx::execution::parallel_policy& policy, const std::function<double(Arg, Args...)>& function,
+                       const mz::approx::internals::make_tuple_of<mz::approx::trapezoidal::variable_integration_info, Arg,Args...>& info){
 
-        return result;
+        return approximate(policy, [&function](const Arg& head, const Args& ...tail){ return function(head, tail...); }, info);
     }
 
 }
@@ -0,0 +1,91 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <filesystem>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    using method = mz::approx::riemann::method::mid_point;
+    using mz::approx::accumulator::mixed_precision;
+    using mz::approx::accumulator::kahan_neumaier;
+    using mz::approx::accumulator::naive;
+
+    // float batch integrands are evaluated in single precision and summed in double, a float sum of the 16 million
+    // outputs would lose several digits
+    {
+        const auto polynomial = [](std::span<const float> x, const float y, std::span<float> output){
+            for (std::size_t i = 0; i < output.size(); i++)
+                output[i] = x[i] * y + x[i] - y;
+        };
+
+        const double mixed = mz::approx::riemann::approximate<method, mixed_precision>(polynomial, {{0.0f, 10.0f, 4000}, {0.0f, 10.0f, 4000}});
+        check_near(mixed, 2500.0, 1e-3, "float batch summed in double");
+
+        const double lanes = mz::approx::riemann::approximate<method>(polynomial, {{0.0f, 10.0f, 4000}, {0.0f, 10.0f, 4000}});
+        check_near(lanes, mixed, 1e-9, "float outputs are accepted by every accumulator");
+
+        const double parallel = mz::approx::riemann::approximate<method, mixed_precision>(mz::approx::execution::parallel_policy{4, 1000},
+                                                                                           polynomial, {{0.0f, 10.0f, 4000}, {0.0f, 10.0f, 400}});
+        check_near(parallel, 2500.0, 1e-3, "parallel float batch");
+
+        const double trapezoidal = mz::approx::trapezoidal::approximate<mixed_precision>(polynomial, {{0.0f, 10.0f, 400}, {0.0f, 10.0f, 400}});
+        check_near(trapezoidal, 2500.0, 1e-3, "weighted float batch");
+
+        // generic batch integrands are recognized by plans
+        const auto plan = mz::approx::riemann::make_plan<method, float, float>({{0.0f, 10.0f, 400}, {0.0f, 10.0f, 400}});
+        const double generic = plan.execute<mixed_precision>([](auto x, auto y, std::span<float> output){
+            for (std::size_t i = 0; i < output.size(); i++)
+                output[i] = x[i] * y + x[i] - y;
+        });
+        check_near(generic, 2500.0, 1e-3, "generic float batch through a plan");
+    }
+
+    const auto function = [](const double x, const double y) -> double { return std::sin(x) + std::cos(y) * x; };
+    const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, double, double> info = {{0.0, 10.0, 120}, {0.0, 10.0, 90}};
+
+    // checkpoints resume the state of the selected accumulator
+    {
+        const auto directory = (std::filesystem::temp_directory_path() / "approx_test_accumulator").string();
+        std::filesystem::remove_all(directory);
+
+        const mz::approx::shard::job job{directory, 1, 1000};
+        check(mz::approx::shard::run<method, kahan_neumaier>(job, function, info) == 120 * 90, "every point is evaluated once");
+        check(mz::approx::shard::merge(job) == mz::approx::riemann::approximate<method, kahan_neumaier>(function, info),
+              "resumed Kahan-Neumaier chain gives the single run result");
+
+        std::filesystem::remove_all(directory);
+    }
+
+    // progressive passes are summed by the selected accumulator
+    {
+        auto handle = mz::approx::async::riemann::approximate<method, naive>(mz::approx::async::inline_executor{}, {}, function, info,
+                                                                             {.passes = 2, .chunk_size = 1000, .on_estimate = {}});
+        check(handle.get().value == mz::approx::riemann::approximate<method, naive>(function, info), "last pass gives the naive sum");
+
+        auto parallel = mz::approx::async::riemann::approximate<method, kahan_neumaier>(mz::approx::async::inline_executor{}, {},
+                mz::approx::execution::parallel_policy{2}, function, info, {.passes = 2, .chunk_size = 1000, .on_estimate = {}});
+        check_near(parallel.get().value, mz::approx::riemann::approximate<method>(function, info), 1e-12, "parallel passes");
+    }
+
+    // separable functions take the accumulator of their axis sums
+    {
+        const auto product = mz::approx::separable::product([](const double x) -> double { return x * x; }, [](const double y) -> double { return y; });
+        const auto sum = mz::approx::separable::sum([](const double x) -> double { return x * x; }, [](const double y) -> double { return y; });
+        const auto curried = mz::approx::separable::curried([](const double x){ return [x](const double y) -> double { return x * y; }; });
+
+        check_near(mz::approx::gauss::approximate<4, naive>(product, {{0.0, 3.0, 1}, {0.0, 2.0, 1}}), 18.0, 1e-12, "separable product");
+        check_near(mz::approx::trapezoidal::approximate<kahan_neumaier>(sum, {{0.0, 3.0, 300}, {0.0, 2.0, 200}}), 24.0, 1e-3, "separable sum");
+        check_near(mz::approx::riemann::approximate<method, naive>(curried, {{0.0, 3.0, 300}, {0.0, 2.0, 200}}), 9.0, 1e-9, "curried function");
+        check_near(mz::approx::riemann::approximate<method, kahan_neumaier>(mz::approx::execution::parallel_policy{3, 7}, curried,
+                                                                              {{0.0, 3.0, 300}, {0.0, 2.0, 200}}), 9.0, 1e-9, "parallel curried function");
+    }
+
+    return failures;
+}
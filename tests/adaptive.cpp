@@ -0,0 +1,50 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <stdexcept>
+#include <numbers>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    // a smooth integrand is integrated exactly by the initial region of 15^2 points
+    const auto smooth = mz::approx::adaptive::approximate([](const double x, const double y) -> double { return std::sin(x) + std::cos(y); },
+                                                          {{0.0, 1.0}, {0.0, 1.0}});
+    check_near(smooth.value, 1 - std::cos(1.0) + std::sin(1.0), 1e-14, "sin(x) + cos(y) over [0, 1]^2");
+    check(smooth.evaluations == 225, "sin(x) + cos(y) needs a single region");
+    check(smooth.error <= 1e-10, "sin(x) + cos(y) error estimate");
+
+    // a peak needs refined regions
+    const auto peak = mz::approx::adaptive::approximate([](const double x) -> double { return 1 / (1e-4 + x * x); }, {{-1.0, 1.0}});
+    check_near(peak.value, 200 * std::atan(100.0), 1e-8 * 200 * std::atan(100.0), "peak over [-1, 1]");
+    check(peak.evaluations > 15, "peak is refined");
+
+    // swapped ranges give the same value
+    const auto swapped = mz::approx::adaptive::approximate([](const double x) -> double { return std::exp(x); }, {{1.0, 0.0}});
+    check_near(swapped.value, std::numbers::e - 1, 1e-14, "exp(x) over a swapped range");
+
+    const std::function<double(double, double)> function = [](const double x, const double y){ return x * y; };
+    check_near(mz::approx::adaptive::approximate<mz::approx::adaptive::rule::gauss_kronrod_21>(function, {{0.0, 2.0}, {0.0, 3.0}}).value,
+               9.0, 1e-13, "std::function with the 21 point rule");
+
+    // the budget has to fit at least the initial region
+    check_throws<std::runtime_error>([]{
+        mz::approx::adaptive::approximate([](const double x, const double y, const double z, const double u, const double v, const double w) -> double {
+            return x + y + z + u + v + w;
+        }, {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}}, {1e-10, 1e-10, 1000});
+    }, "budget smaller than a region");
+
+    // a budget below the tolerance stops refining but keeps the estimate
+    const auto limited = mz::approx::adaptive::approximate([](const double x) -> double { return 1 / (1e-4 + x * x); }, {{-1.0, 1.0}},
+                                                           {1e-14, 1e-14, 150});
+    check(limited.evaluations <= 150, "refinement stays within the budget");
+    check(limited.error > 0, "limited run reports its error");
+
+    return failures;
+}
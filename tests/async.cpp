@@ -0,0 +1,105 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <stop_token>
+#include <numbers>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    using method = mz::approx::riemann::method::mid_point;
+    const auto function = [](const double x, const double y) -> double { return std::sin(x) + std::cos(y); };
+
+    // every pass publishes an estimate, the last one is the Kahan sum over the full grid
+    {
+        std::vector<mz::approx::async::estimate> estimates;
+        auto handle = mz::approx::async::riemann::approximate<method>(mz::approx::async::inline_executor{}, {}, function,
+                {{0.0, 1.0, 256}, {0.0, 1.0, 256}}, {.passes = 4, .chunk_size = 1000, .on_estimate = [&](const auto& next){ estimates.push_back(next); }});
+
+        const auto final = handle.get();
+        check(estimates.size() == 4, "one estimate per pass");
+        check(std::isinf(estimates.front().error) && !estimates.front().complete, "first pass has no error estimate");
+        check(final.complete && final.pass == 3, "last pass is complete");
+        check(final.evaluations == 32 * 32 + 64 * 64 + 128 * 128 + 256 * 256, "evaluations of all passes");
+        check(final.value == mz::approx::riemann::approximate<method, mz::approx::accumulator::kahan>(function, {{0.0, 1.0, 256}, {0.0, 1.0, 256}}),
+              "last pass gives the sequential result");
+        check(final.error < estimates[1].error, "error estimate shrinks");
+    }
+
+    // a caller bound by a deadline takes the estimate of the coarse pass while the fine one is still running
+    {
+        std::atomic<unsigned long int> calls = 0;
+        std::atomic<bool> release = false;
+
+        auto handle = mz::approx::async::riemann::approximate<method>(mz::approx::async::thread_executor{}, {}, [&](const double x) -> double {
+            // points past the first pass wait until the deadline has passed
+            if (++calls > 1024)
+                while (!release)
+                    std::this_thread::yield();
+            return x;
+        }, {{0.0, 1.0, 2048}}, {.passes = 2, .chunk_size = 64, .on_estimate = {}});
+
+        const auto partial = handle.wait_for(std::chrono::milliseconds(200));
+        check(partial.has_value() && partial->pass == 0 && !partial->complete, "deadline gives the coarse estimate");
+        check(partial.has_value() && std::fabs(partial->value - 0.5) < 1e-12, "coarse estimate of x over [0, 1]");
+        check(!handle.is_ready(), "integration is still running at the deadline");
+
+        release = true;
+        const auto final = handle.get();
+        check(final.complete && std::fabs(final.value - 0.5) < 1e-12, "integration finishes after the deadline");
+    }
+
+    // a stop request of the token ends the integration within a single chunk
+    {
+        std::stop_source source;
+        unsigned long int calls = 0;
+        const unsigned long int stop_at = 1024 + 100;
+
+        auto handle = mz::approx::async::riemann::approximate<method>(mz::approx::async::inline_executor{}, source.get_token(), [&](const double x) -> double {
+            if (++calls == stop_at)
+                source.request_stop();
+            return x;
+        }, {{0.0, 1.0, 1ul << 16}}, {.passes = 7, .chunk_size = 64, .on_estimate = {}});
+
+        check(calls >= stop_at && calls < stop_at + 64, "stop ends the integration within one chunk");
+
+        const auto latest = handle.get();
+        check(latest.pass == 0 && !latest.complete, "stopped integration resolves with the latest estimate");
+    }
+
+    // stopping before the first pass is finished leaves no estimate
+    {
+        std::stop_source source;
+        source.request_stop();
+
+        auto handle = mz::approx::async::riemann::approximate<method>(mz::approx::async::inline_executor{}, source.get_token(), function,
+                                                                      {{0.0, 1.0, 256}, {0.0, 1.0, 256}});
+        check(!handle.latest().has_value(), "no estimate before the first pass");
+        check_throws<mz::approx::async::cancelled>([&]{ handle.get(); }, "stopped before the first pass");
+    }
+
+    // parallel passes and quasi Monte Carlo passes
+    {
+        auto parallel = mz::approx::async::riemann::approximate<method>(mz::approx::async::thread_executor{}, {}, mz::approx::execution::parallel_policy{4},
+                                                                        function, {{0.0, 1.0, 512}, {0.0, 1.0, 512}}, {.passes = 5, .chunk_size = 4096, .on_estimate = {}});
+        check_near(parallel.get().value, 1 - std::cos(1.0) + std::sin(1.0), 1e-6, "parallel passes");
+
+        auto sampled = mz::approx::async::montecarlo::approximate(mz::approx::async::thread_executor{}, {}, [](const double x) -> double { return std::exp(x); },
+                                                                  {{0.0, 1.0}});
+        const auto estimate = sampled.get();
+        check(estimate.complete && estimate.evaluations == 1ul << 16, "quasi Monte Carlo passes");
+        check_near(estimate.value, std::numbers::e - 1, std::max(5 * estimate.error, 1e-12), "quasi Monte Carlo estimate");
+    }
+
+    return failures;
+}
@@ -0,0 +1,52 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef APPROX_TESTS_CHECK_HPP
+#define APPROX_TESTS_CHECK_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+namespace mz::approx::tests {
+
+    // number of failed checks, tests return it from main so ctest reports any of them
+    inline int failures = 0;
+
+    inline void check(bool condition, const char* name){
+        if (!condition){
+            std::cerr << "failed: " << name << std::endl;
+            failures++;
+        }
+    }
+
+    // used to compare results with closed form values, tolerance is absolute
+    inline void check_near(double value, double expected, double tolerance, const char* name){
+        if (!(std::fabs(value - expected) <= tolerance)){
+            std::cerr << std::setprecision(17) << "failed: " << name << " value: " << value << " expected: " << expected
+                      << " tolerance: " << tolerance << std::endl;
+            failures++;
+        }
+    }
+
+    // used to check that f throws the exception E
+    template <typename E, typename F>
+    void check_throws(F&& f, const char* name){
+        try {
+            f();
+        }
+        catch (const E&){
+            return;
+        }
+        catch (...){
+        }
+
+        std::cerr << "failed: " << name << " did not throw the expected exception" << std::endl;
+        failures++;
+    }
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    // engines returning a result struct report their value and error, every call of the integrand is counted
+    {
+        mz::approx::adaptive::result direct;
+        const auto measured = mz::approx::instrument::measure([](const double x) -> double { return 1 / (1e-4 + x * x); }, [&](auto& f){
+            direct = mz::approx::adaptive::approximate(f, {{-1.0, 1.0}});
+            return direct;
+        });
+
+        check(measured.evaluations == direct.evaluations, "adaptive evaluations");
+        check(measured.value == direct.value, "adaptive value");
+        check(measured.error.has_value() && *measured.error == direct.error, "adaptive error");
+        check(measured.threads.size() == 1, "adaptive runs on a single thread");
+        check(measured.wall_time >= measured.integrand_time, "integrand time is a part of the wall time");
+    }
+
+    // every thread which evaluated the integrand has its own entry, the integrand sleeps so all of them get some chunks
+    {
+        const auto measured = mz::approx::instrument::measure([](const double x) -> double {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            return x;
+        }, [](auto& f){
+            return mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(mz::approx::execution::parallel_policy{4, 1}, f, {{0.0, 1.0, 200}});
+        });
+
+        check_near(measured.value, 0.5, 1e-12, "parallel riemann value");
+        check(!measured.error.has_value(), "riemann gives no error estimate");
+        check(measured.evaluations == 200, "parallel riemann evaluations");
+        check(measured.threads.size() == 4, "parallel riemann reports 4 threads");
+
+        unsigned long int evaluations = 0;
+        for (const auto& thread : measured.threads)
+            evaluations += thread.evaluations;
+        check(evaluations == measured.evaluations, "per thread evaluations add up");
+    }
+
+    // engines writing their outputs into a span are measured without a value
+    {
+        std::vector<double> outputs(2);
+        const auto measured = mz::approx::instrument::measure([](const double x, std::span<double> out){ out[0] = 1; out[1] = x; }, [&](auto& f){
+            mz::approx::riemann::approximate<mz::approx::riemann::method::mid_point>(f, {{0.0, 2.0, 100}}, std::span<double>(outputs));
+        });
+
+        check(measured.evaluations == 100, "span integrand evaluations");
+        check_near(outputs[0], 2.0, 1e-12, "span integrand first output");
+        check_near(outputs[1], 2.0, 1e-12, "span integrand second output");
+    }
+
+    return failures;
+}
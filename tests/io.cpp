@@ -0,0 +1,113 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <vector>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    using method = mz::approx::riemann::method::mid_point;
+    const auto directory = std::filesystem::temp_directory_path();
+
+    // plain samples written and read back are bit for bit the same and integrate like the samples held in memory
+    {
+        const auto path = (directory / "approx_test_io_plain.bin").string();
+
+        std::vector<double> inputs(1001);
+        std::vector<double> outputs(inputs.size());
+        for (std::size_t index = 0; index < inputs.size(); index++){
+            inputs[index] = 0.001 * index;
+            outputs[index] = std::exp(inputs[index]);
+        }
+
+        mz::approx::io::write_sample_file(path, std::make_tuple(std::span<const double>(inputs)), std::span<const double>(outputs));
+        const mz::approx::io::sample_file file(path);
+
+        check(file.type() == mz::approx::io::dtype::float64, "plain samples dtype");
+        check(file.dimensions() == 1 && file.extent(0) == inputs.size(), "plain samples extents");
+        check(std::ranges::equal(file.axis<double>(0), inputs), "plain samples inputs");
+        check(std::ranges::equal(file.outputs<double>(), outputs), "plain samples outputs");
+
+        const double expected = mz::approx::riemann::approximate<method>(std::span<const double>(inputs), std::span<const double>(outputs));
+        check(mz::approx::io::approximate<method>(file) == expected, "plain samples integrate like samples in memory");
+        check(mz::approx::io::approximate<method>(mz::approx::execution::parallel_policy{4, 100}, file) == expected, "parallel plain samples");
+        check_near(expected, std::exp(1.0) - 1, 1e-6, "plain samples of exp(x) over [0, 1]");
+
+        check_throws<std::runtime_error>([&]{ file.outputs<float>(); }, "reading float64 columns as float32");
+        std::filesystem::remove(path);
+    }
+
+    // samples of a float32 tensor grid
+    {
+        const auto path = (directory / "approx_test_io_grid.bin").string();
+
+        std::vector<float> x(30);
+        std::vector<float> y(20);
+        std::vector<float> outputs;
+        for (std::size_t index = 0; index < x.size(); index++)
+            x[index] = static_cast<float>(index) / (x.size() - 1);
+        for (std::size_t index = 0; index < y.size(); index++)
+            y[index] = 2.0f * index / (y.size() - 1);
+        for (const auto y_value : y)
+            for (const auto x_value : x)
+                outputs.push_back(x_value + y_value);
+
+        mz::approx::io::write_sample_file(path, std::make_tuple(std::span<const float>(x), std::span<const float>(y)), std::span<const float>(outputs));
+        const mz::approx::io::sample_file file(path);
+
+        check(file.type() == mz::approx::io::dtype::float32, "grid dtype");
+        check(file.dimensions() == 2 && file.extent(0) == x.size() && file.extent(1) == y.size(), "grid extents");
+        check(std::ranges::equal(file.axis<float>(1), y), "grid axis");
+        check(std::ranges::equal(file.outputs<float>(), outputs), "grid outputs");
+
+        const double sequential = mz::approx::io::approximate<method, 2, float>(file);
+        check_near(sequential, 3.0, 1e-5, "x + y over [0, 1] x [0, 2]");
+        check(mz::approx::io::approximate<method, 2, float>(mz::approx::execution::parallel_policy{3, 7}, file) == sequential, "parallel grid");
+        std::filesystem::remove(path);
+    }
+
+    // malformed files are rejected
+    {
+        const auto path = (directory / "approx_test_io_malformed.bin").string();
+
+        const auto write = [&](const std::vector<char>& bytes){
+            std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+            stream.write(bytes.data(), bytes.size());
+        };
+
+        const auto header = [](std::uint32_t dimensions, const std::vector<std::uint64_t>& extents){
+            std::vector<char> bytes(mz::approx::io::sample_file_magic.begin(), mz::approx::io::sample_file_magic.end());
+            bytes.resize(16 + 8 * extents.size());
+            std::copy_n(reinterpret_cast<const char*>(&dimensions), sizeof(dimensions), bytes.begin() + 12);
+            std::copy_n(reinterpret_cast<const char*>(extents.data()), 8 * extents.size(), bytes.begin() + 16);
+            return bytes;
+        };
+
+        write({'N', 'O', 'T', 'S', 'M', 'P', 'L', '1', 0, 0, 0, 0, 1, 0, 0, 0});
+        check_throws<std::runtime_error>([&]{ mz::approx::io::sample_file file(path); }, "wrong magic");
+
+        write(header(0, {}));
+        check_throws<std::runtime_error>([&]{ mz::approx::io::sample_file file(path); }, "no dimensions");
+
+        write(header(1, {10}));
+        check_throws<std::runtime_error>([&]{ mz::approx::io::sample_file file(path); }, "truncated columns");
+
+        write(header(2, {1ull << 61, 8}));
+        check_throws<std::runtime_error>([&]{ mz::approx::io::sample_file file(path); }, "overflowing extents");
+
+        std::filesystem::remove(path);
+    }
+
+    return failures;
+}
@@ -0,0 +1,54 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <stdexcept>
+#include <numbers>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+// estimates have to be within a few standard errors of the exact value, the standard error itself has to be small
+template <typename Sequence>
+void check_sequence(const char* name, double tolerance){
+    const auto function = [](const double x, const double y, const double z) -> double { return std::exp(x + y + z); };
+    const double exact = std::pow(std::numbers::e - 1, 3);
+
+    const auto sequential = mz::approx::montecarlo::approximate<Sequence>(function, {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}});
+    check_near(sequential.value, exact, std::max(5 * sequential.standard_error, 1e-12), name);
+    check(sequential.standard_error < tolerance, name);
+    check(sequential.evaluations == 1ul << 16, name);
+
+    // samples are generated from their indices so the number of threads and chunks does not change any bit
+    const auto single = mz::approx::montecarlo::approximate<Sequence>(mz::approx::execution::parallel_policy{1}, function,
+                                                                      {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}});
+    const auto parallel = mz::approx::montecarlo::approximate<Sequence>(mz::approx::execution::parallel_policy{8, 1000}, function,
+                                                                        {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}});
+    check(single.value == sequential.value && single.standard_error == sequential.standard_error, name);
+    check(parallel.value == sequential.value && parallel.standard_error == sequential.standard_error, name);
+}
+
+int main() {
+
+    check_sequence<mz::approx::montecarlo::sequence::sobol>("sobol", 5e-4);
+    check_sequence<mz::approx::montecarlo::sequence::halton>("halton", 1e-3);
+    check_sequence<mz::approx::montecarlo::sequence::pseudo_random>("pseudo_random", 2e-2);
+
+    // swapped ranges and a different seed still estimate the same integral
+    const auto swapped = mz::approx::montecarlo::approximate([](const double x) -> double { return x * x; }, {{3.0, 0.0}}, {1ul << 12, 8, 42});
+    check_near(swapped.value, 9.0, std::max(5 * swapped.standard_error, 1e-12), "swapped range");
+
+    const std::function<double(double, double)> function = [](const double x, const double y){ return x * y; };
+    const auto product = mz::approx::montecarlo::approximate(function, {{0.0, 2.0}, {0.0, 2.0}});
+    check_near(product.value, 4.0, std::max(5 * product.standard_error, 1e-12), "std::function");
+
+    // sobol indices of a replicate have 32 bits
+    check_throws<std::runtime_error>([]{
+        mz::approx::montecarlo::approximate([](const double x) -> double { return x; }, {{0.0, 1.0}}, {1ul << 34, 2, 0});
+    }, "too many sobol samples per replicate");
+
+    return failures;
+}
@@ -0,0 +1,45 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <numbers>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    // nodes of coarser levels are reused so a smooth integrand converges within a few dozens of evaluations
+    const auto exponential = mz::approx::romberg::approximate([](const double x) -> double { return std::exp(x); }, {{0.0, 1.0}});
+    check_near(exponential.value, std::numbers::e - 1, 1e-15, "exp(x) over [0, 1]");
+    check(exponential.evaluations <= 33, "exp(x) needs at most 33 evaluations");
+    check(exponential.error <= 1e-10, "exp(x) error estimate");
+
+    // the parallel engine sums the new nodes of every level in chunks merged in a fixed order
+    const auto function = [](const double x, const double y) -> double { return std::sin(x) * std::exp(y); };
+    const double exact = (1 - std::cos(2.0)) * (std::numbers::e - 1);
+
+    const auto sequential = mz::approx::romberg::approximate(function, {{0.0, 2.0}, {0.0, 1.0}});
+    const auto parallel = mz::approx::romberg::approximate(mz::approx::execution::parallel_policy{4, 16}, function, {{0.0, 2.0}, {0.0, 1.0}});
+    check_near(sequential.value, exact, 1e-10, "sin(x) exp(y) over [0, 2] x [0, 1]");
+    check_near(parallel.value, exact, 1e-10, "parallel sin(x) exp(y) over [0, 2] x [0, 1]");
+    check(parallel.evaluations == sequential.evaluations, "parallel evaluations");
+
+    // reproducible regardless of the number of threads
+    const auto single = mz::approx::romberg::approximate(mz::approx::execution::parallel_policy{1, 16}, function, {{0.0, 2.0}, {0.0, 1.0}});
+    check(single.value == parallel.value, "parallel result does not depend on the number of threads");
+
+    // the evaluation budget stops the refinement before the tolerance is reached
+    const auto limited = mz::approx::romberg::approximate([](const double x) -> double { return std::sqrt(x); }, {{0.0, 1.0}},
+                                                          {.absolute = 1e-15, .relative = 1e-15, .max_evaluations = 100});
+    check(limited.evaluations <= 100, "refinement stays within the budget");
+    check_near(limited.value, 2.0 / 3, 1e-3, "sqrt(x) over [0, 1] within the budget");
+
+    const std::function<double(double)> polynomial = [](const double x){ return x * x * x; };
+    check_near(mz::approx::romberg::approximate(polynomial, {{0.0, 2.0, 4}}).value, 4.0, 1e-14, "std::function");
+
+    return failures;
+}
@@ -0,0 +1,89 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    using method = mz::approx::riemann::method::mid_point;
+
+    const auto function = [](const double x, const double y, const double z) -> double { return std::sin(x) + std::cos(y) * z; };
+    const mz::approx::internals::make_tuple_of<mz::approx::riemann::variable_integration_info, double, double, double>
+            info = {{0.0, 10.0, 60}, {0.0, 10.0, 50}, {0.0, 1.0, 40}};
+    const unsigned long int size = 60 * 50 * 40;
+
+    // a single process run with one Kahan chain over all points
+    const double expected = mz::approx::riemann::approximate<method, mz::approx::accumulator::kahan>(function, info);
+    const auto directory = (std::filesystem::temp_directory_path() / "approx_test_shard").string();
+
+    for (const unsigned long int segments : {1ul, 7ul, 64ul}){
+        std::filesystem::remove_all(directory);
+        const mz::approx::shard::job job{directory, segments};
+
+        check(mz::approx::shard::run<method>(job, function, info) == size, "every point is evaluated once");
+        check(mz::approx::shard::merge(job) == expected, "merged segments give the single process result");
+
+        // finished segments are not evaluated again
+        check(mz::approx::shard::run<method>(job, function, info) == 0, "finished job is not evaluated again");
+    }
+
+    // checkpoints in the middle of segments resume the same Kahan chain
+    std::filesystem::remove_all(directory);
+    mz::approx::shard::run<method>(mz::approx::shard::job{directory, 7, 1000}, function, info);
+    check(mz::approx::shard::merge(mz::approx::shard::job{directory, 7, 1000}) == expected, "checkpoint interval does not change the result");
+
+    // a process preempted in the middle of the job is resumed from its last checkpoint by the next one
+    {
+        std::filesystem::remove_all(directory);
+        const mz::approx::shard::job job{directory, 7, 1000};
+
+        unsigned long int calls = 0;
+        check_throws<std::runtime_error>([&]{
+            mz::approx::shard::run<method>(job, [&](const double x, const double y, const double z) -> double {
+                if (++calls > 50'000)
+                    throw std::runtime_error("preempted");
+                return function(x, y, z);
+            }, info);
+        }, "preempted run");
+
+        check_throws<std::runtime_error>([&]{ mz::approx::shard::merge(job); }, "merge of an unfinished job");
+
+        const auto evaluated = mz::approx::shard::run<method>(job, function, info);
+        check(evaluated < size && evaluated >= size - 50'000, "resumed run evaluates only the remaining points");
+        check(mz::approx::shard::merge(job) == expected, "resumed job gives the single process result");
+    }
+
+    // concurrent processes claim disjoint segments
+    {
+        std::filesystem::remove_all(directory);
+        const mz::approx::shard::job job{directory, 64, 1000};
+
+        std::atomic<unsigned long int> evaluated = 0;
+        {
+            std::vector<std::jthread> processes;
+            for (int process = 0; process < 4; process++)
+                processes.emplace_back([&]{ evaluated += mz::approx::shard::run<method>(job, function, info); });
+        }
+
+        check(evaluated == size, "concurrent runs evaluate every point once");
+        check(mz::approx::shard::merge(job) == expected, "concurrent runs give the single process result");
+
+        // checkpoints of a different grid are rejected
+        check_throws<std::runtime_error>([&]{
+            mz::approx::shard::run<method>(mz::approx::shard::job{directory, 64}, function, {{0.0, 5.0, 60}, {0.0, 10.0, 50}, {0.0, 1.0, 40}});
+        }, "checkpoints of a different job");
+    }
+
+    std::filesystem::remove_all(directory);
+    return failures;
+}
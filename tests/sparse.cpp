@@ -0,0 +1,44 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <numbers>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    // smooth product of exponentials over [0, 1]^8 with the exact value (e - 1)^8
+    const auto function = [](const double x, const double y, const double z, const double u,
+                             const double v, const double w, const double s, const double t) -> double {
+        return std::exp(x + y + z + u + v + w + s + t);
+    };
+    const double exact = std::pow(std::numbers::e - 1, 8);
+
+    const auto sequential = mz::approx::sparse::approximate(function, {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0},
+                                                                       {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}}, {.max_level = 8});
+    check_near(sequential.value, exact, 1e-10 * exact, "exp product over [0, 1]^8");
+    check(sequential.evaluations < 1'000'000, "sparse grid of [0, 1]^8 is far smaller than a tensor grid");
+
+    // nodes are evaluated in parallel while the summation order stays the same
+    const auto parallel = mz::approx::sparse::approximate(mz::approx::execution::parallel_policy{4, 100}, function,
+                                                          {{0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0},
+                                                           {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0}}, {.max_level = 8});
+    check(parallel.value == sequential.value, "parallel result is identical");
+    check(parallel.evaluations == sequential.evaluations, "parallel evaluations");
+
+    // polynomials of low degree are integrated exactly already on coarse levels
+    const auto polynomial = mz::approx::sparse::approximate([](const double x, const double y) -> double { return x * x * y; },
+                                                            {{-1.0, 2.0}, {0.0, 2.0}}, {.max_level = 3, .absolute = 0, .relative = 0});
+    check_near(polynomial.value, 6.0, 1e-13, "x^2 y over [-1, 2] x [0, 2]");
+    check(polynomial.level == 3, "refinement runs up to the maximal level without a tolerance");
+
+    const std::function<double(double)> cosine = [](const double x){ return std::cos(x); };
+    check_near(mz::approx::sparse::approximate(cosine, {{0.0, std::numbers::pi / 2}}).value, 1.0, 1e-12, "std::function");
+
+    return failures;
+}
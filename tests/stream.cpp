@@ -0,0 +1,55 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <limits>
+#include <vector>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+// both namespaces together still name the accumulator policies and the stream accumulator unambiguously
+using namespace mz::approx;
+using namespace mz::approx::riemann;
+
+int main() {
+
+    std::vector<double> inputs(100'001);
+    std::vector<double> outputs(inputs.size());
+    for (std::size_t index = 0; index < inputs.size(); index++){
+        inputs[index] = 1e-5 * index;
+        outputs[index] = std::sin(inputs[index]);
+    }
+
+    stream_accumulator<method::mid_point, double, double> stream;
+    stream.push(std::span<const double>(inputs), std::span<const double>(outputs));
+    check(stream.size() == inputs.size(), "every sample is counted");
+    check_near(stream.result(), 1 - std::cos(1.0), 1e-10, "sin(x) over [0, 1]");
+
+    // adjacent halves merged into one cover the same intervals as a single stream
+    const std::size_t half = inputs.size() / 2;
+    stream_accumulator<method::mid_point, double, double> first;
+    stream_accumulator<method::mid_point, double, double> second;
+    first.push(std::span<const double>(inputs).first(half), std::span<const double>(outputs).first(half));
+    second.push(std::span<const double>(inputs).subspan(half), std::span<const double>(outputs).subspan(half));
+    first.merge(second);
+
+    check(first.size() == stream.size(), "merged accumulator counts both halves");
+    check_near(first.result(), stream.result(), 2 * std::numeric_limits<double>::epsilon() * stream.result(),
+               "merged result differs only in the last bits");
+
+    // merging with empty accumulators changes nothing
+    stream_accumulator<method::mid_point, double, double> empty;
+    check(empty.merge(stream).result() == stream.result(), "merge into an empty accumulator");
+    check(stream.merge(stream_accumulator<method::mid_point, double, double>()).result() == empty.result(), "merge of an empty accumulator");
+
+    // accumulator policies are reachable next to the stream accumulator
+    accumulator::kahan sum;
+    sum.add(1.0);
+    check(sum.total() == 1.0, "accumulator policies are not hidden by the stream accumulator");
+
+    return failures;
+}
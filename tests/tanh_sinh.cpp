@@ -0,0 +1,48 @@
+//          Copyright Mateusz Jaworski 2021 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE.md or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include "../include/approx/approx.hpp"
+#include "check.hpp"
+#include <numbers>
+#include <limits>
+#include <cmath>
+
+using namespace mz::approx::tests;
+
+int main() {
+
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    // singular end point, the integrand is never evaluated at x = 0
+    const auto singular = mz::approx::tanh_sinh::approximate([](const double x) -> double { return 1 / std::sqrt(x); }, {{0.0, 1.0}});
+    check_near(singular.value, 2.0, 1e-9, "1 / sqrt(x) over [0, 1]");
+
+    // half infinite and infinite ranges
+    const auto decay = mz::approx::tanh_sinh::approximate([](const double x) -> double { return std::exp(-x); }, {{0.0, infinity}});
+    check_near(decay.value, 1.0, 1e-9, "exp(-x) over [0, inf)");
+
+    const auto gaussian = mz::approx::tanh_sinh::approximate([](const double x) -> double { return std::exp(-x * x); }, {{-infinity, infinity}});
+    check_near(gaussian.value, std::sqrt(std::numbers::pi), 1e-9, "exp(-x^2) over (-inf, inf)");
+
+    const auto growth = mz::approx::tanh_sinh::approximate([](const double x) -> double { return std::exp(x); }, {{-infinity, 0.0}});
+    check_near(growth.value, 1.0, 1e-9, "exp(x) over (-inf, 0]");
+
+    // swapped bounds are ordered like by the other engines
+    const auto swapped = mz::approx::tanh_sinh::approximate([](const double x) -> double { return std::exp(-x); }, {{infinity, 0.0}});
+    check_near(swapped.value, 1.0, 1e-9, "exp(-x) over a swapped range");
+
+    // product of a singular and an infinite dimension, the parallel engine gives the same evaluations
+    const auto function = [](const double x, const double y) -> double { return std::exp(-y) / std::sqrt(x); };
+    const auto sequential = mz::approx::tanh_sinh::approximate(function, {{0.0, 1.0}, {0.0, infinity}});
+    const auto parallel = mz::approx::tanh_sinh::approximate(mz::approx::execution::parallel_policy{4, 64}, function, {{0.0, 1.0}, {0.0, infinity}});
+    check_near(sequential.value, 2.0, 1e-8, "exp(-y) / sqrt(x) over [0, 1] x [0, inf)");
+    check_near(parallel.value, 2.0, 1e-8, "parallel exp(-y) / sqrt(x) over [0, 1] x [0, inf)");
+    check(parallel.evaluations == sequential.evaluations, "parallel evaluations");
+
+    const std::function<double(double)> logarithm = [](const double x){ return std::log(x); };
+    check_near(mz::approx::tanh_sinh::approximate(logarithm, {{0.0, 1.0}}).value, -1.0, 1e-9, "std::function log(x) over [0, 1]");
+
+    return failures;
+}